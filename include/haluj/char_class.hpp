@@ -0,0 +1,264 @@
+/// \file char_class.hpp
+/// ASCII character classes with table lookup and bulk scanning
+/*
+This is free and unencumbered software released into the public domain.
+
+Anyone is free to copy, modify, publish, use, compile, sell, or
+distribute this software, either in source code form or as a compiled
+binary, for any purpose, commercial or non-commercial, and by any
+means.
+
+In jurisdictions that recognize copyright laws, the author or authors
+of this software dedicate any and all copyright interest in the
+software to the public domain. We make this dedication for the benefit
+of the public at large and to the detriment of our heirs and
+successors. We intend this dedication to be an overt act of
+relinquishment in perpetuity of all present and future rights to this
+software under copyright law.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+
+For more information, please refer to <http://unlicense.org>
+*/
+/// \author Selcuk Iyikalender
+/// \date   2026
+
+/*! Classes match the C locale definitions of the <cctype> functions.
+* scan<Mask>(first, last) returns the first position in [first, last)
+* whose character is not in any of the classes in Mask. With SSE2 or AVX2
+* enabled at compile time, 16 or 32 bytes are tested per step.
+* scan_bounded<Mask>(first, limit, last) stops at limit at the latest.
+*/
+
+#ifndef HALUJ_CHAR_CLASS_HPP
+#define HALUJ_CHAR_CLASS_HPP
+
+#include <cstdint>
+#include <array>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace haluj
+{
+
+namespace char_class
+{
+
+typedef std::uint8_t mask_type;
+
+constexpr mask_type alpha     = 0x01;
+constexpr mask_type digit     = 0x02;
+constexpr mask_type space     = 0x04;
+constexpr mask_type hex_digit = 0x08;
+constexpr mask_type upper     = 0x10;
+constexpr mask_type alnum     = alpha | digit;
+
+constexpr mask_type classify(const unsigned c)
+{
+  mask_type result = 0;
+
+  if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) result |= alpha;
+  if (c >= 'A' && c <= 'Z')                             result |= upper;
+  if (c >= '0' && c <= '9')                             result |= digit | hex_digit;
+  if ((c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F')) result |= hex_digit;
+  if (c == ' ' || (c >= '\t' && c <= '\r'))             result |= space;
+
+  return result;
+}
+
+constexpr std::array<mask_type, 256> make_table()
+{
+  std::array<mask_type, 256> result = {};
+  for (unsigned c = 0; c < 256; c++)
+  {
+    result[c] = classify(c);
+  }
+  return result;
+}
+
+constexpr std::array<mask_type, 256> table = make_table();
+
+template<mask_type Mask, typename CharType>
+constexpr bool test(const CharType c)
+{
+  return (table[static_cast<unsigned char>(c)] & Mask) != 0;
+}
+
+inline const char* scan_scalar_(const char*      first,
+                                const char*      last,
+                                const mask_type  mask)
+{
+  while (first != last && (table[static_cast<unsigned char>(*first)] & mask))
+  {
+    first++;
+  }
+  return first;
+}
+
+#if defined(__AVX2__)
+
+/// lanes of v in [lo, hi] are set to 0xFF
+inline __m256i in_range_(const __m256i v, const char lo, const char hi)
+{
+  const __m256i t = _mm256_sub_epi8(v, _mm256_set1_epi8(lo));
+  return
+    _mm256_cmpeq_epi8(_mm256_min_epu8(t, _mm256_set1_epi8(char(hi - lo))), t);
+}
+
+template<mask_type Mask>
+inline __m256i match_(const __m256i v)
+{
+  const __m256i folded  = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+  __m256i       result  = _mm256_setzero_si256();
+
+  if constexpr ((Mask & alpha) != 0)
+    result = _mm256_or_si256(result, in_range_(folded, 'a', 'z'));
+  if constexpr ((Mask & upper) != 0)
+    result = _mm256_or_si256(result, in_range_(v, 'A', 'Z'));
+  if constexpr ((Mask & (digit | hex_digit)) != 0)
+    result = _mm256_or_si256(result, in_range_(v, '0', '9'));
+  if constexpr ((Mask & hex_digit) != 0)
+    result = _mm256_or_si256(result, in_range_(folded, 'a', 'f'));
+  if constexpr ((Mask & space) != 0)
+    result =
+      _mm256_or_si256(result,
+                      _mm256_or_si256(in_range_(v, '\t', '\r'),
+                                      _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '))));
+  return result;
+}
+
+#elif defined(__SSE2__)
+
+/// lanes of v in [lo, hi] are set to 0xFF
+inline __m128i in_range_(const __m128i v, const char lo, const char hi)
+{
+  const __m128i t = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+  return _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8(char(hi - lo))), t);
+}
+
+template<mask_type Mask>
+inline __m128i match_(const __m128i v)
+{
+  const __m128i folded  = _mm_or_si128(v, _mm_set1_epi8(0x20));
+  __m128i       result  = _mm_setzero_si128();
+
+  if constexpr ((Mask & alpha) != 0)
+    result = _mm_or_si128(result, in_range_(folded, 'a', 'z'));
+  if constexpr ((Mask & upper) != 0)
+    result = _mm_or_si128(result, in_range_(v, 'A', 'Z'));
+  if constexpr ((Mask & (digit | hex_digit)) != 0)
+    result = _mm_or_si128(result, in_range_(v, '0', '9'));
+  if constexpr ((Mask & hex_digit) != 0)
+    result = _mm_or_si128(result, in_range_(folded, 'a', 'f'));
+  if constexpr ((Mask & space) != 0)
+    result =
+      _mm_or_si128(result,
+                   _mm_or_si128(in_range_(v, '\t', '\r'),
+                                _mm_cmpeq_epi8(v, _mm_set1_epi8(' '))));
+  return result;
+}
+
+#endif
+
+/// scan: first position in [first, last) not in classes of Mask
+template<mask_type Mask>
+inline const char* scan(const char* first, const char* last)
+{
+#if defined(__AVX2__)
+  while (last - first >= 32)
+  {
+    const __m256i   v     =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+    const unsigned  miss  = ~static_cast<unsigned>(_mm256_movemask_epi8(match_<Mask>(v)));
+
+    if (miss != 0)
+    {
+      return first + __builtin_ctz(miss);
+    }
+    first += 32;
+  }
+#elif defined(__SSE2__)
+  while (last - first >= 16)
+  {
+    const __m128i   v     =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+    const unsigned  miss  =
+      ~static_cast<unsigned>(_mm_movemask_epi8(match_<Mask>(v))) & 0xFFFFU;
+
+    if (miss != 0)
+    {
+      return first + __builtin_ctz(miss);
+    }
+    first += 16;
+  }
+#endif
+  return scan_scalar_(first, last, Mask);
+}
+
+template<mask_type Mask>
+inline char* scan(char* first, char* last)
+{
+  return first + (scan<Mask>(static_cast<const char*>(first), last) - first);
+}
+
+/// scan_bounded: as scan over [first, limit), limit <= last. Whole vectors 
+/// are loaded as long as they end before last, so short limits are tested
+/// with a single compare when enough input follows
+template<mask_type Mask>
+inline const char* scan_bounded(const char* first, 
+                                const char* limit, 
+                                const char* last)
+{
+#if defined(__AVX2__)
+  while (first < limit && last - first >= 32)
+  {
+    const __m256i   v     =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+    const unsigned  miss  = ~static_cast<unsigned>(_mm256_movemask_epi8(match_<Mask>(v)));
+
+    if (miss != 0)
+    {
+      first += __builtin_ctz(miss);
+      return (first < limit) ? first : limit;
+    }
+    first += 32;
+  }
+#elif defined(__SSE2__)
+  while (first < limit && last - first >= 16)
+  {
+    const __m128i   v     =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+    const unsigned  miss  =
+      ~static_cast<unsigned>(_mm_movemask_epi8(match_<Mask>(v))) & 0xFFFFU;
+
+    if (miss != 0)
+    {
+      first += __builtin_ctz(miss);
+      return (first < limit) ? first : limit;
+    }
+    first += 16;
+  }
+#endif
+  return (first < limit) ? scan_scalar_(first, limit, Mask) : limit;
+}
+
+template<mask_type Mask>
+inline char* scan_bounded(char* first, char* limit, char* last)
+{
+  return 
+    first + (scan_bounded<Mask>(static_cast<const char*>(first), limit, last) - first);
+}
+
+} // namespace char_class
+
+} // namespace haluj
+
+#endif // HALUJ_CHAR_CLASS_HPP
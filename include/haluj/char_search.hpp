@@ -0,0 +1,114 @@
+/// \file char_search.hpp
+/// Fast character search over contiguous char ranges
+/*
+This is free and unencumbered software released into the public domain.
+
+Anyone is free to copy, modify, publish, use, compile, sell, or
+distribute this software, either in source code form or as a compiled
+binary, for any purpose, commercial or non-commercial, and by any
+means.
+
+In jurisdictions that recognize copyright laws, the author or authors
+of this software dedicate any and all copyright interest in the
+software to the public domain. We make this dedication for the benefit
+of the public at large and to the detriment of our heirs and
+successors. We intend this dedication to be an overt act of
+relinquishment in perpetuity of all present and future rights to this
+software under copyright law.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+
+For more information, please refer to <http://unlicense.org>
+*/
+/// \author Selcuk Iyikalender
+/// \date   2026
+
+#ifndef HALUJ_CHAR_SEARCH_HPP
+#define HALUJ_CHAR_SEARCH_HPP
+
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace haluj
+{
+
+/// find_char: first position of p_c in [first, last), last if not found
+inline const char* find_char(const char* first, const char* last, const char p_c)
+{
+  const void* result = std::memchr(first, p_c, last - first);
+  return (result != nullptr) ? static_cast<const char*>(result) : last;
+}
+
+inline char* find_char(char* first, char* last, const char p_c)
+{
+  return first + (find_char(static_cast<const char*>(first), last, p_c) - first);
+}
+
+/// find_either: first position of p_a or p_b in [first, last), last if
+/// not found
+inline const char* find_either(const char* first,
+                               const char* last,
+                               const char  p_a,
+                               const char  p_b)
+{
+#if defined(__AVX2__)
+  const __m256i a = _mm256_set1_epi8(p_a);
+  const __m256i b = _mm256_set1_epi8(p_b);
+
+  while (last - first >= 32)
+  {
+    const __m256i   v   =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+    const unsigned  hit =
+      static_cast<unsigned>(
+        _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, a),
+                                             _mm256_cmpeq_epi8(v, b))));
+    if (hit != 0)
+    {
+      return first + __builtin_ctz(hit);
+    }
+    first += 32;
+  }
+#elif defined(__SSE2__)
+  const __m128i a = _mm_set1_epi8(p_a);
+  const __m128i b = _mm_set1_epi8(p_b);
+
+  while (last - first >= 16)
+  {
+    const __m128i   v   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+    const unsigned  hit =
+      static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, a),
+                                       _mm_cmpeq_epi8(v, b))));
+    if (hit != 0)
+    {
+      return first + __builtin_ctz(hit);
+    }
+    first += 16;
+  }
+#endif
+  while (first != last && *first != p_a && *first != p_b)
+  {
+    first++;
+  }
+  return first;
+}
+
+inline char* find_either(char* first, char* last, const char p_a, const char p_b)
+{
+  return
+    first + (find_either(static_cast<const char*>(first), last, p_a, p_b) - first);
+}
+
+} // namespace haluj
+
+#endif // HALUJ_CHAR_SEARCH_HPP
@@ -0,0 +1,234 @@
+/// \file mpmc_queue.hpp
+/// A bounded multi producer multi consumer queue
+/*
+This is free and unencumbered software released into the public domain.
+
+Anyone is free to copy, modify, publish, use, compile, sell, or
+distribute this software, either in source code form or as a compiled
+binary, for any purpose, commercial or non-commercial, and by any
+means.
+
+In jurisdictions that recognize copyright laws, the author or authors
+of this software dedicate any and all copyright interest in the
+software to the public domain. We make this dedication for the benefit
+of the public at large and to the detriment of our heirs and
+successors. We intend this dedication to be an overt act of
+relinquishment in perpetuity of all present and future rights to this
+software under copyright law.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+
+For more information, please refer to <http://unlicense.org>
+*/
+/// \author Selcuk Iyikalender
+/// \date   2026
+
+/*! Basic usage:
+* \code {.cpp}
+* // storage is declared the same way as ring_buffer storage
+* haluj::concurrent::mpmc_queue<std::array<job, 256>> q;
+* // any producer thread
+* if (!q.try_push(j)) { ... }
+* // any consumer thread
+* job j;
+* q.pop(j); // waits until an element is available
+* \endcode
+*/
+
+#ifndef HALUJ_CONCURRENT_MPMC_QUEUE_HPP
+#define HALUJ_CONCURRENT_MPMC_QUEUE_HPP
+
+#include <cstdint>
+#include <atomic>
+#include <thread>
+
+#include "../container_traits.hpp"
+#include "../utility.hpp"
+
+namespace haluj
+{
+
+namespace concurrent
+{
+
+/// Bounded lock-free queue for many producers and many consumers.
+/// Each slot carries a sequence number telling whether it is ready to be
+/// written or read for the current lap (D. Vyukov's bounded MPMC queue).
+/// RandomAccessContainerType is only used to describe the storage, e.g.
+/// std::array<T, N> or bounded::vector<T, N>; the queue stores its slots in
+/// the same container template rebound to the slot type. Power of two
+/// capacities turn the index modulo into a mask.
+
+template<typename RandomAccessContainerType>
+struct mpmc_queue
+{
+  typedef RandomAccessContainerType             container_type;
+  typedef typename container_type::value_type   base_type;
+  typedef std::size_t                           index_type;
+
+  static constexpr std::size_t c_capacity =
+    static_capacity<container_type>::value;
+
+  static_assert(c_capacity > 0,
+                "mpmc_queue requires a fixed capacity container");
+
+  struct cell
+  {
+    std::atomic<index_type>   sequence;
+    base_type                 data;
+  };
+
+  typedef typename rebind_container<container_type, cell>::type cells_type;
+
+  mpmc_queue()
+  {
+    clear();
+  }
+
+  mpmc_queue(const mpmc_queue& ) = delete;
+
+  mpmc_queue(mpmc_queue&& ) = delete;
+
+  /// clear the queue, not thread safe
+  void clear()
+  {
+    for (index_type i = 0; i < c_capacity; i++)
+    {
+      m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    m_enqueue.store(0, std::memory_order_relaxed);
+    m_dequeue.store(0, std::memory_order_relaxed);
+  }
+
+  constexpr std::size_t capacity() const
+  {
+    return c_capacity;
+  }
+
+  /// size: approximate number of elements, exact when queue is quiescent
+  std::size_t size() const
+  {
+    const index_type d = m_dequeue.load(std::memory_order_acquire);
+    const index_type e = m_enqueue.load(std::memory_order_acquire);
+    return (e > d) ? (e - d) : 0;
+  }
+
+  bool empty() const
+  {
+    return size() == 0;
+  }
+
+  /// try_push: returns false if queue is full
+  bool try_push(const base_type &p_data)
+  {
+    index_type  pos = m_enqueue.load(std::memory_order_relaxed);
+    cell*       c;
+
+    for (;;)
+    {
+      c = &m_cells[pos % c_capacity];
+
+      const index_type  seq  = c->sequence.load(std::memory_order_acquire);
+      const auto        diff =
+        static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+
+      if (diff == 0)
+      {
+        if (m_enqueue.compare_exchange_weak(pos, pos + 1,
+                                            std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (diff < 0)
+      {
+        return false;
+      }
+      else
+      {
+        pos = m_enqueue.load(std::memory_order_relaxed);
+      }
+    }
+
+    c->data = p_data;
+    c->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// try_pop: returns false if queue is empty
+  bool try_pop(base_type &p_data)
+  {
+    index_type  pos = m_dequeue.load(std::memory_order_relaxed);
+    cell*       c;
+
+    for (;;)
+    {
+      c = &m_cells[pos % c_capacity];
+
+      const index_type  seq  = c->sequence.load(std::memory_order_acquire);
+      const auto        diff =
+        static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+
+      if (diff == 0)
+      {
+        if (m_dequeue.compare_exchange_weak(pos, pos + 1,
+                                            std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (diff < 0)
+      {
+        return false;
+      }
+      else
+      {
+        pos = m_dequeue.load(std::memory_order_relaxed);
+      }
+    }
+
+    p_data = c->data;
+    c->sequence.store(pos + c_capacity, std::memory_order_release);
+    return true;
+  }
+
+  /// push: waits while queue is full. WaitFunction is called on each retry
+  template<typename WaitFunction>
+  void push(const base_type &p_data, WaitFunction p_wait)
+  {
+    while (!try_push(p_data)) p_wait();
+  }
+
+  void push(const base_type &p_data)
+  {
+    push(p_data, [](){ std::this_thread::yield(); });
+  }
+
+  /// pop: waits while queue is empty. WaitFunction is called on each retry
+  template<typename WaitFunction>
+  void pop(base_type &p_data, WaitFunction p_wait)
+  {
+    while (!try_pop(p_data)) p_wait();
+  }
+
+  void pop(base_type &p_data)
+  {
+    pop(p_data, [](){ std::this_thread::yield(); });
+  }
+
+  alignas(cache_line_size) cells_type               m_cells;
+  alignas(cache_line_size) std::atomic<index_type>  m_enqueue;
+  alignas(cache_line_size) std::atomic<index_type>  m_dequeue;
+};
+
+} // namespace concurrent
+
+} // namespace haluj
+
+#endif // HALUJ_CONCURRENT_MPMC_QUEUE_HPP
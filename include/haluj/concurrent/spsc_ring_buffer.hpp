@@ -0,0 +1,216 @@
+/// \file spsc_ring_buffer.hpp
+/// A lock-free single producer single consumer ring buffer
+/*
+This is free and unencumbered software released into the public domain.
+
+Anyone is free to copy, modify, publish, use, compile, sell, or
+distribute this software, either in source code form or as a compiled
+binary, for any purpose, commercial or non-commercial, and by any
+means.
+
+In jurisdictions that recognize copyright laws, the author or authors
+of this software dedicate any and all copyright interest in the
+software to the public domain. We make this dedication for the benefit
+of the public at large and to the detriment of our heirs and
+successors. We intend this dedication to be an overt act of
+relinquishment in perpetuity of all present and future rights to this
+software under copyright law.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+
+For more information, please refer to <http://unlicense.org>
+*/
+/// \author Selcuk Iyikalender
+/// \date   2026
+
+/*! Basic usage:
+* \code {.cpp}
+* haluj::concurrent::spsc_ring_buffer<std::array<int, 1024>> q;
+* // producer thread
+* while (!q.try_push(v)) {}
+* // consumer thread
+* int v;
+* if (q.try_pop(v)) { ... }
+* \endcode
+* Exactly one thread may call the producer side methods (push, try_push) and
+* exactly one thread may call the consumer side methods (front, pop, try_pop).
+*/
+
+#ifndef HALUJ_CONCURRENT_SPSC_RING_BUFFER_HPP
+#define HALUJ_CONCURRENT_SPSC_RING_BUFFER_HPP
+
+#include <cstdint>
+#include <atomic>
+
+#include "../cyclic_index.hpp"
+#include "../utility.hpp"
+
+namespace haluj
+{
+
+namespace concurrent
+{
+
+/// Lock-free ring buffer for one producer and one consumer thread.
+/// Head and tail are kept on separate cache lines and each side caches the
+/// last seen value of the opposite index, so the shared cache line is only
+/// touched when the buffer looks full (producer) or empty (consumer).
+/// Indices run in [0, 2 * capacity) so that the whole storage can be used
+/// without an additional empty/full flags word.
+
+template<typename RandomAccessContainerType>
+struct spsc_ring_buffer
+{
+  typedef RandomAccessContainerType             container_type;
+  typedef typename container_type::value_type   base_type;
+  typedef std::size_t                           index_type;
+
+  spsc_ring_buffer()
+  {
+    clear();
+  }
+
+  spsc_ring_buffer(const spsc_ring_buffer& ) = delete;
+
+  spsc_ring_buffer(spsc_ring_buffer&& ) = delete;
+
+  /// clear the buffer, not thread safe
+  void clear()
+  {
+    m_head.store(0, std::memory_order_relaxed);
+    m_tail.store(0, std::memory_order_relaxed);
+    m_tail_cache  = 0;
+    m_head_cache  = 0;
+  }
+
+  /// capacity: maximum number of elements
+  constexpr std::size_t capacity() const
+  {
+    return m_container.size();
+  }
+
+  /// size: how many elements are written/available to read
+  std::size_t size() const
+  {
+    return distance(m_head.load(std::memory_order_acquire),
+                    m_tail.load(std::memory_order_acquire));
+  }
+
+  /// remaining: remaining free space to write
+  std::size_t remaining() const
+  {
+    return capacity() - size();
+  }
+
+  /// full: returns true if buffer is full
+  bool full() const
+  {
+    return size() == capacity();
+  }
+
+  /// empty: returns true if buffer is empty
+  bool empty() const
+  {
+    return m_head.load(std::memory_order_acquire) ==
+           m_tail.load(std::memory_order_acquire);
+  }
+
+  /// try_push: Add a new element to head, returns false if buffer is full.
+  /// Producer side only
+  bool try_push(const base_type &p_data)
+  {
+    const index_type head = m_head.load(std::memory_order_relaxed);
+
+    if (distance(head, m_tail_cache) == capacity())
+    {
+      m_tail_cache = m_tail.load(std::memory_order_acquire);
+
+      if (distance(head, m_tail_cache) == capacity())
+      {
+        return false;
+      }
+    }
+
+    m_container[slot(head)] = p_data;
+    m_head.store(cyclic_increment(head, 2 * capacity()),
+                 std::memory_order_release);
+    return true;
+  }
+
+  /// push: Add a new element to head, waits while buffer is full.
+  /// Producer side only
+  void push(const base_type &p_data)
+  {
+    while (!try_push(p_data));
+  }
+
+  /// try_pop: remove element from the tail into p_data, returns false if
+  /// buffer is empty. Consumer side only
+  bool try_pop(base_type &p_data)
+  {
+    const index_type tail = m_tail.load(std::memory_order_relaxed);
+
+    if (tail == m_head_cache)
+    {
+      m_head_cache = m_head.load(std::memory_order_acquire);
+
+      if (tail == m_head_cache)
+      {
+        return false;
+      }
+    }
+
+    p_data = m_container[slot(tail)];
+    m_tail.store(cyclic_increment(tail, 2 * capacity()),
+                 std::memory_order_release);
+    return true;
+  }
+
+  /// pop: remove element from the tail. Buffer should not be empty.
+  /// Consumer side only
+  void pop()
+  {
+    const index_type tail = m_tail.load(std::memory_order_relaxed);
+    m_tail.store(cyclic_increment(tail, 2 * capacity()),
+                 std::memory_order_release);
+  }
+
+  /// front: element at the tail. Buffer should not be empty.
+  /// Consumer side only
+  base_type& front()
+  {
+    return m_container[slot(m_tail.load(std::memory_order_relaxed))];
+  }
+
+  index_type slot(const index_type p_index) const
+  {
+    return (p_index < capacity()) ? p_index : (p_index - capacity());
+  }
+
+  index_type distance(const index_type p_head, const index_type p_tail) const
+  {
+    return (p_head < p_tail) ? (2 * capacity() + p_head - p_tail)
+                             : (p_head - p_tail);
+  }
+
+  // producer side
+  alignas(cache_line_size) std::atomic<index_type>  m_head;
+  index_type                                        m_tail_cache;
+  // consumer side
+  alignas(cache_line_size) std::atomic<index_type>  m_tail;
+  index_type                                        m_head_cache;
+
+  alignas(cache_line_size) container_type           m_container;
+};
+
+} // namespace concurrent
+
+} // namespace haluj
+
+#endif // HALUJ_CONCURRENT_SPSC_RING_BUFFER_HPP
@@ -0,0 +1,75 @@
+/// \file container_traits.hpp
+/// Compile time information about fixed capacity containers
+/*
+This is free and unencumbered software released into the public domain.
+
+Anyone is free to copy, modify, publish, use, compile, sell, or
+distribute this software, either in source code form or as a compiled
+binary, for any purpose, commercial or non-commercial, and by any
+means.
+
+In jurisdictions that recognize copyright laws, the author or authors
+of this software dedicate any and all copyright interest in the
+software to the public domain. We make this dedication for the benefit
+of the public at large and to the detriment of our heirs and
+successors. We intend this dedication to be an overt act of
+relinquishment in perpetuity of all present and future rights to this
+software under copyright law.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+
+For more information, please refer to <http://unlicense.org>
+*/
+/// \author Selcuk Iyikalender
+/// \date   2026
+
+#ifndef HALUJ_CONTAINER_TRAITS_HPP
+#define HALUJ_CONTAINER_TRAITS_HPP
+
+#include <cstdint>
+#include <type_traits>
+
+namespace haluj
+{
+
+/// static_capacity: capacity of containers declared as C<T, N>
+/// (e.g. std::array, bounded::vector). value is 0 when unknown
+
+template<typename ContainerType>
+struct static_capacity : std::integral_constant<std::size_t, 0>
+{};
+
+template<template<typename, std::size_t> class C,
+         typename    T,
+         std::size_t N>
+struct static_capacity<C<T, N>> : std::integral_constant<std::size_t, N>
+{};
+
+/// rebind_container: same container template holding another value type
+
+template<typename ContainerType, typename ValueType>
+struct rebind_container;
+
+template<template<typename, std::size_t> class C,
+         typename    T,
+         std::size_t N,
+         typename    ValueType>
+struct rebind_container<C<T, N>, ValueType>
+{
+  typedef C<ValueType, N> type;
+};
+
+constexpr bool is_power_of_two(const std::size_t p_value)
+{
+  return (p_value != 0) && ((p_value & (p_value - 1)) == 0);
+}
+
+} // namespace haluj
+
+#endif // HALUJ_CONTAINER_TRAITS_HPP
@@ -0,0 +1,479 @@
+/// \file coroutine.hpp
+/// Single threaded coroutine scheduler with suspending waits (C++20)
+/*
+This is free and unencumbered software released into the public domain.
+
+Anyone is free to copy, modify, publish, use, compile, sell, or
+distribute this software, either in source code form or as a compiled
+binary, for any purpose, commercial or non-commercial, and by any
+means.
+
+In jurisdictions that recognize copyright laws, the author or authors
+of this software dedicate any and all copyright interest in the
+software to the public domain. We make this dedication for the benefit
+of the public at large and to the detriment of our heirs and
+successors. We intend this dedication to be an overt act of
+relinquishment in perpetuity of all present and future rights to this
+software under copyright law.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+
+For more information, please refer to <http://unlicense.org>
+*/
+/// \author Selcuk Iyikalender
+/// \date   2026
+
+/*! Basic usage:
+* \code {.cpp}
+* haluj::task handshake(link& l)
+* {
+*   // set then wait for ack, replaces a polled haluj::set_and_wait
+*   co_await haluj::set_and_wait([&] { l.send_request(); }, 
+*                                [&] { return l.ack(); });
+*   co_await haluj::sleep(100);   // 100 scheduler ticks
+*   co_await l.ready_event;       // haluj::event, set by another task
+* }
+*
+* haluj::scheduler s;
+* s.spawn(handshake(l));
+* for (;;)
+* {
+*   s.run();    // resume whatever is ready
+*   s.tick();   // once per tick, e.g. every millisecond
+* }
+* \endcode
+* Sleeping tasks wait in a timer_wheel and events keep their own waiters,
+* neither is looked at until it fires. Conditions of wait_until and
+* set_and_wait are not: run() calls the predicate of every such waiter
+* each time, without resuming its task, so they cost like the polled 
+* versions minus the resumption. A loop like async_loop becomes a plain
+* for loop with co_await yield() in its body. run() resumes only the tasks
+* ready when it is called, tasks made ready meanwhile (by yield, an event
+* or spawn) wait for the next run(), so a yield loop does not keep tick()
+* from being called.
+* Tasks are started by spawn and destroyed by the scheduler when they
+* finish or when the scheduler is destroyed; events must not outlive the
+* scheduler of their waiters.
+*/
+
+#ifndef HALUJ_COROUTINE_HPP
+#define HALUJ_COROUTINE_HPP
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <cstdint>
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+#include "timer_wheel.hpp"
+
+namespace haluj
+{
+
+struct scheduler;
+
+/// waiter: intrusive list node of a suspended task
+struct waiter
+{
+  waiter*                 next_     = nullptr;
+  std::coroutine_handle<> handle_;
+  bool                  (*test_)(waiter&) = nullptr;
+};
+
+/// waiter_list: FIFO of waiters
+struct waiter_list
+{
+  bool empty() const
+  {
+    return head_ == nullptr;
+  }
+
+  void push_back(waiter& p_waiter)
+  {
+    p_waiter.next_ = nullptr;
+    *tail_ = &p_waiter;
+    tail_  = &p_waiter.next_;
+  }
+
+  waiter& pop_front()
+  {
+    waiter& result = *head_;
+    head_ = result.next_;
+    if (head_ == nullptr) tail_ = &head_;
+    return result;
+  }
+
+  void clear()
+  {
+    head_ = nullptr;
+    tail_ = &head_;
+  }
+
+  /// splice: move the waiters of p_list to the back, p_list becomes empty
+  void splice(waiter_list& p_list)
+  {
+    if (!p_list.empty())
+    {
+      *tail_ = p_list.head_;
+      tail_  = p_list.tail_;
+      p_list.clear();
+    }
+  }
+
+  waiter*   head_ = nullptr;
+  waiter**  tail_ = &head_;
+};
+
+/// task: coroutine type run by a scheduler
+struct task
+{
+  struct promise_type
+  {
+    task get_return_object()
+    {
+      return task(handle_type::from_promise(*this));
+    }
+
+    std::suspend_always initial_suspend() noexcept 
+    { 
+      return {}; 
+    }
+
+    std::suspend_always final_suspend() noexcept 
+    { 
+      return {}; 
+    }
+
+    void return_void() 
+    {}
+
+    void unhandled_exception() 
+    { 
+      std::terminate(); 
+    }
+
+    scheduler*    scheduler_  = nullptr;
+    promise_type* prev_       = nullptr;  // list of live tasks
+    promise_type* next_       = nullptr;
+    waiter        start_;
+  };
+
+  typedef std::coroutine_handle<promise_type> handle_type;
+
+  explicit task(handle_type p_handle)
+  : handle_(p_handle)
+  {}
+
+  task(const task& ) = delete;
+
+  task(task&& p_other)
+  : handle_(std::exchange(p_other.handle_, nullptr))
+  {}
+
+  ~task()
+  {
+    if (handle_) handle_.destroy();
+  }
+
+  handle_type handle_;
+};
+
+struct scheduler
+{
+  typedef timer_wheel<one_shot>           wheel_type;
+  typedef wheel_type::duration            duration;
+  typedef task::promise_type              promise_type;
+
+  scheduler()
+  {}
+
+  scheduler(const scheduler& ) = delete;
+
+  scheduler(scheduler&& ) = delete;
+
+  ~scheduler()
+  {
+    while (live_ != nullptr)
+    {
+      promise_type* p = live_;
+      live_ = p->next_;
+      task::handle_type::from_promise(*p).destroy();
+    }
+    ready_.clear();
+    conditions_.clear();
+  }
+
+  /// spawn: take over p_task and queue it to start at the next run
+  void spawn(task p_task)
+  {
+    promise_type& p = p_task.handle_.promise();
+    p.scheduler_        = this;
+    p.start_.handle_    = std::exchange(p_task.handle_, nullptr);
+    p.prev_             = nullptr;
+    p.next_             = live_;
+    if (live_ != nullptr) live_->prev_ = &p;
+    live_ = &p;
+    ready_.push_back(p.start_);
+  }
+
+  /// run: test wait_until conditions and resume the tasks which are ready
+  /// at this point, each once. Returns the number of resumptions
+  std::size_t run()
+  {
+    test_conditions_();
+
+    waiter_list ready;
+    ready.splice(ready_);
+
+    std::size_t result = 0;
+    while (!ready.empty())
+    {
+      resume_(ready.pop_front().handle_);
+      result++;
+    }
+    return result;
+  }
+
+  /// tick: advance sleeping tasks by p_delta ticks
+  void tick(duration p_delta = 1)
+  {
+    wheel_([this](wheel_type::timer& t) { ready(waiter_of_(t)); }, p_delta);
+  }
+
+  /// empty: true when no task is alive
+  bool empty() const
+  {
+    return live_ == nullptr;
+  }
+
+  void ready(waiter& p_waiter)
+  {
+    ready_.push_back(p_waiter);
+  }
+
+  void wait(waiter& p_waiter)
+  {
+    conditions_.push_back(p_waiter);
+  }
+
+// private:
+
+  struct sleeper : wheel_type::timer, waiter
+  {};
+
+  static waiter& waiter_of_(wheel_type::timer& p_timer)
+  {
+    return static_cast<sleeper&>(p_timer);
+  }
+
+  void test_conditions_()
+  {
+    waiter** link = &conditions_.head_;
+    while (*link != nullptr)
+    {
+      waiter& w = **link;
+      if (w.test_(w))
+      {
+        *link = w.next_;
+        if (*link == nullptr) conditions_.tail_ = link;
+        ready_.push_back(w);
+      }
+      else
+      {
+        link = &w.next_;
+      }
+    }
+  }
+
+  void resume_(std::coroutine_handle<> p_handle)
+  {
+    p_handle.resume();
+    if (p_handle.done())
+    {
+      promise_type& p = 
+        task::handle_type::from_address(p_handle.address()).promise();
+      if (p.prev_ != nullptr) p.prev_->next_ = p.next_; else live_ = p.next_;
+      if (p.next_ != nullptr) p.next_->prev_ = p.prev_;
+      p_handle.destroy();
+    }
+  }
+
+  wheel_type      wheel_;
+  waiter_list     ready_;
+  waiter_list     conditions_;
+  promise_type*   live_       = nullptr;
+};
+
+/// scheduler_of_: scheduler running the awaiting task
+inline scheduler& scheduler_of_(std::coroutine_handle<task::promise_type> p_handle)
+{
+  return *p_handle.promise().scheduler_;
+}
+
+/// Awaitable suspending until Test returns true
+template<typename Test>
+struct wait_until_awaiter : waiter
+{
+  explicit wait_until_awaiter(Test p_test)
+  : test_function_(std::move(p_test))
+  {}
+
+  bool await_ready()
+  {
+    return test_function_();
+  }
+
+  void await_suspend(std::coroutine_handle<task::promise_type> p_handle)
+  {
+    handle_ = p_handle;
+    test_   = [](waiter& w) { return static_cast<wait_until_awaiter&>(w).test_function_(); };
+    scheduler_of_(p_handle).wait(*this);
+  }
+
+  void await_resume()
+  {}
+
+  Test test_function_;
+};
+
+template<typename Test>
+wait_until_awaiter<Test> wait_until(Test p_test)
+{
+  return wait_until_awaiter<Test>(std::move(p_test));
+}
+
+/// set_and_wait: call p_set, then wait until p_test returns true
+template<typename SetFunction, typename TestFunction>
+wait_until_awaiter<TestFunction> set_and_wait(SetFunction p_set, TestFunction p_test)
+{
+  p_set();
+  return wait_until_awaiter<TestFunction>(std::move(p_test));
+}
+
+/// Awaitable suspending for a number of scheduler ticks
+struct sleep_awaiter : scheduler::sleeper
+{
+  explicit sleep_awaiter(scheduler::duration p_ticks)
+  : ticks_(p_ticks)
+  {}
+
+  bool await_ready() const
+  {
+    return ticks_ == 0;
+  }
+
+  void await_suspend(std::coroutine_handle<task::promise_type> p_handle)
+  {
+    handle_ = p_handle;
+    scheduler_of_(p_handle).wheel_.set(*this, ticks_);
+  }
+
+  void await_resume()
+  {}
+
+  scheduler::duration ticks_;
+};
+
+inline sleep_awaiter sleep(scheduler::duration p_ticks)
+{
+  return sleep_awaiter(p_ticks);
+}
+
+/// Awaitable letting other ready tasks run first
+struct yield_awaiter : waiter
+{
+  bool await_ready() const
+  {
+    return false;
+  }
+
+  void await_suspend(std::coroutine_handle<task::promise_type> p_handle)
+  {
+    handle_ = p_handle;
+    scheduler_of_(p_handle).ready(*this);
+  }
+
+  void await_resume()
+  {}
+};
+
+inline yield_awaiter yield()
+{
+  return yield_awaiter();
+}
+
+/// event: tasks awaiting it are suspended until set
+struct event
+{
+  struct awaiter : waiter
+  {
+    explicit awaiter(event& p_event)
+    : event_(p_event)
+    {}
+
+    bool await_ready() const
+    {
+      return event_.is_set();
+    }
+
+    void await_suspend(std::coroutine_handle<task::promise_type> p_handle)
+    {
+      handle_     = p_handle;
+      scheduler_  = &scheduler_of_(p_handle);
+      event_.waiters_.push_back(*this);
+    }
+
+    void await_resume()
+    {}
+
+    event&      event_;
+    scheduler*  scheduler_ = nullptr;
+  };
+
+  event()
+  {}
+
+  event(const event& ) = delete;
+
+  /// set: wake all waiting tasks, later awaits do not suspend until reset
+  void set()
+  {
+    set_ = true;
+    while (!waiters_.empty())
+    {
+      awaiter& a = static_cast<awaiter&>(waiters_.pop_front());
+      a.scheduler_->ready(a);
+    }
+  }
+
+  void reset()
+  {
+    set_ = false;
+  }
+
+  bool is_set() const
+  {
+    return set_;
+  }
+
+  awaiter operator co_await()
+  {
+    return awaiter(*this);
+  }
+
+  waiter_list waiters_;
+  bool        set_ = false;
+};
+
+} // namespace haluj
+
+#endif // __cpp_impl_coroutine
+
+#endif // HALUJ_COROUTINE_HPP
@@ -51,7 +51,7 @@ template<typename T>
 inline T cyclic_increment(const T v, T size, const T N)
 {
   auto result = v + size;
-  if (result > N)
+  if (result >= N)
     result -= N;
   return result;
 }
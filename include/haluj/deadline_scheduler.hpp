@@ -0,0 +1,325 @@
+/// \file deadline_scheduler.hpp
+/// Deadline ordered timers polled with one clock read
+/*
+This is free and unencumbered software released into the public domain.
+
+Anyone is free to copy, modify, publish, use, compile, sell, or
+distribute this software, either in source code form or as a compiled
+binary, for any purpose, commercial or non-commercial, and by any
+means.
+
+In jurisdictions that recognize copyright laws, the author or authors
+of this software dedicate any and all copyright interest in the
+software to the public domain. We make this dedication for the benefit
+of the public at large and to the detriment of our heirs and
+successors. We intend this dedication to be an overt act of
+relinquishment in perpetuity of all present and future rights to this
+software under copyright law.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+
+For more information, please refer to <http://unlicense.org>
+*/
+/// \author Selcuk Iyikalender
+/// \date   2026
+
+/*! Basic usage:
+* \code {.cpp}
+* typedef haluj::deadline_scheduler<std::chrono::steady_clock> scheduler;
+* scheduler           s;
+* scheduler::timer    t;
+* s.set(t, std::chrono::milliseconds(20));
+* for (;;)
+* {
+*   auto wait = s.next_deadline() - std::chrono::steady_clock::now();
+*   epoll_wait(fd, events, n, to_milliseconds(wait));  
+*   s([](scheduler::timer& x) { ... });
+* }
+* \endcode
+* Timers are kept in an intrusive 4-ary min heap ordered by deadline. A
+* poll reads the clock once and only touches expired timers. Like 
+* timer_implementations::chrono, an expired timer which keeps running is
+* rescheduled at timeout_ + load_, so periods do not drift, and it fires
+* at most once per poll. Expired timers keep their heap slot reserved 
+* until their function has returned, so set() from inside a function can
+* not take the room needed to reschedule them.
+*/
+
+#ifndef HALUJ_DEADLINE_SCHEDULER_HPP
+#define HALUJ_DEADLINE_SCHEDULER_HPP
+
+#include <cstdint>
+#include <array>
+#include <type_traits>
+
+#include "timer.hpp"
+
+namespace haluj
+{
+
+template
+<
+  typename    Clock,
+  typename    Duration  = typename Clock::duration,
+  typename    Behaviour = periodic,
+  std::size_t Capacity  = 256
+>
+struct deadline_scheduler
+{
+  // Types
+
+  typedef typename Clock::time_point  time_point;
+  typedef Duration                    duration;
+  typedef Behaviour                   behaviour;
+
+  static constexpr std::size_t c_arity    = 4;
+  static constexpr std::size_t c_none     = std::size_t(-1);
+  static constexpr std::size_t c_pending  = std::size_t(-2);
+
+  /// Timer entry. It must not move or be destroyed while running
+
+  struct timer
+  {
+    timer()
+    {}
+
+    timer(const timer& ) = delete;
+
+    timer(timer&& ) = delete;
+
+    bool is_running() const
+    {
+      return run_;
+    }
+
+    /// timeout: deadline of the next expiration
+    time_point timeout() const
+    {
+      return timeout_;
+    }
+
+    bool        run_      = false;
+    std::size_t index_    = c_none;   // position in heap, or c_none/c_pending
+    timer*      next_     = nullptr;  // list of expired timers in a poll
+    time_point  timeout_  = time_point();
+    duration    load_     = duration();
+  };
+
+  typedef std::array<timer*, Capacity> heap_type;
+
+  // Constructors
+
+  deadline_scheduler()
+  {}
+
+  deadline_scheduler(const deadline_scheduler& ) = delete;
+
+  deadline_scheduler(deadline_scheduler&& ) = delete;
+
+  // Operators
+
+  /// fire expired timers, calling p_function(timer&) through the behaviour
+  /// for each one in deadline order. Returns the number of expirations
+  template<typename Function = std::nullptr_t>
+  std::size_t operator()(Function p_function = Function())
+  {
+    return (*this)(p_function, Clock::now());
+  }
+
+  /// as above with the current time supplied by the caller
+  template<typename Function>
+  std::size_t operator()(Function p_function, const time_point p_now)
+  {
+    std::size_t result  = 0;
+    timer*      pending = nullptr;
+    timer**     tail    = &pending;
+
+    while ((size_ != 0) && (heap_[0]->timeout_ <= p_now))
+    {
+      timer& t = *heap_[0];
+      remove_(0);
+      reserved_++;
+      t.index_  = c_pending;
+      t.next_   = nullptr;
+      *tail     = &t;
+      tail      = &t.next_;
+    }
+
+    while (pending != nullptr)
+    {
+      timer& t = *pending;
+      pending = t.next_;
+      if (t.index_ != c_pending)
+      {
+        // stopped or set again by an earlier function
+        continue;
+      }
+      result++;
+
+      const bool done = fire_(t, p_function);
+      if (t.index_ != c_pending)
+      {
+        // stopped or set again by the function
+        continue;
+      }
+      reserved_--;
+      t.index_ = c_none;
+      if (done)
+      {
+        t.run_ = false;
+      }
+      else if (t.run_)
+      {
+        // room is left by the reservation
+        t.timeout_ += t.load_;
+        push_(t);
+      }
+    }
+
+    return result;
+  }
+
+  // Methods
+
+  /// set: load p_value and start p_timer, it expires p_value from now.
+  /// Returns false if the scheduler is full, counting the slots reserved
+  /// for timers expired in the current poll
+  bool set(timer& p_timer, duration p_value)
+  {
+    stop(p_timer);
+    bool result = (size_ + reserved_ < Capacity);
+    if (result)
+    {
+      p_timer.load_     = p_value;
+      p_timer.timeout_  = Clock::now() + p_value;
+      p_timer.run_      = true;
+      push_(p_timer);
+    }
+    return result;
+  }
+
+  /// load: period used from the next expiration on
+  void load(timer& p_timer, duration p_value)
+  {
+    p_timer.load_ = p_value;
+  }
+
+  void stop(timer& p_timer)
+  {
+    if (p_timer.index_ < size_)
+    {
+      remove_(p_timer.index_);
+    }
+    else if (p_timer.index_ == c_pending)
+    {
+      reserved_--;
+    }
+    p_timer.index_  = c_none;
+    p_timer.run_    = false;
+  }
+
+  bool empty() const
+  {
+    return size_ == 0;
+  }
+
+  std::size_t size() const
+  {
+    return size_;
+  }
+
+  /// next_deadline: earliest timeout, time_point::max() when empty
+  time_point next_deadline() const
+  {
+    return (size_ == 0) ? time_point::max() : heap_[0]->timeout_;
+  }
+
+// private:
+
+  void place_(timer* p_timer, const std::size_t p_index)
+  {
+    heap_[p_index]    = p_timer;
+    p_timer->index_   = p_index;
+  }
+
+  void sift_up_(std::size_t p_index)
+  {
+    timer* t = heap_[p_index];
+    while (p_index > 0)
+    {
+      const std::size_t parent = (p_index - 1) / c_arity;
+      if (!(t->timeout_ < heap_[parent]->timeout_)) break;
+      place_(heap_[parent], p_index);
+      p_index = parent;
+    }
+    place_(t, p_index);
+  }
+
+  void sift_down_(std::size_t p_index)
+  {
+    timer*            t     = heap_[p_index];
+    const std::size_t size  = size_;
+    for (;;)
+    {
+      const std::size_t first = p_index * c_arity + 1;
+      if (first >= size) break;
+
+      const std::size_t last  = (first + c_arity < size) ? first + c_arity : size;
+      std::size_t       min   = first;
+      for (std::size_t i = first + 1; i < last; i++)
+      {
+        if (heap_[i]->timeout_ < heap_[min]->timeout_) min = i;
+      }
+      if (!(heap_[min]->timeout_ < t->timeout_)) break;
+      place_(heap_[min], p_index);
+      p_index = min;
+    }
+    place_(t, p_index);
+  }
+
+  void push_(timer& p_timer)
+  {
+    heap_[size_] = &p_timer;
+    sift_up_(size_++);
+  }
+
+  void remove_(const std::size_t p_index)
+  {
+    const std::size_t last = --size_;
+    heap_[p_index]->index_ = c_none;
+    if (p_index != last)
+    {
+      place_(heap_[last], p_index);
+      sift_down_(p_index);
+      sift_up_(p_index);
+    }
+  }
+
+  template<typename Function>
+  bool fire_(timer& p_timer, Function& p_function)
+  {
+    if constexpr (std::is_same<Function, std::nullptr_t>::value)
+    {
+      return behaviour_(nullptr);
+    }
+    else
+    {
+      return behaviour_([&]() { return p_function(p_timer); });
+    }
+  }
+
+  heap_type   heap_     = {};
+  std::size_t size_     = 0;
+  std::size_t reserved_ = 0;  // expired timers not yet handled by a poll
+  behaviour   behaviour_;
+};
+
+} // namespace haluj
+
+#endif // HALUJ_DEADLINE_SCHEDULER_HPP
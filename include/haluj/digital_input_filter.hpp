@@ -32,6 +32,7 @@ For more information, please refer to <http://unlicense.org>
 #ifndef HALUJ_DIGITAL_INPUT_FILTER_HPP
 #define HALUJ_DIGITAL_INPUT_FILTER_HPP
 
+#include <cstdint>
 #include <algorithm>
 
 template<typename T, unsigned BufferSize>
@@ -92,5 +93,153 @@ struct digital_input_filter
   T      m_edge;
 };
 
+/// Same filter as digital_input_filter in O(log BufferSize) per sample.
+/// Instead of the sample history, each bit keeps the number of consecutive
+/// ones it has seen, saturated at BufferSize, in bit sliced form: plane k
+/// holds bit k of all the counters. A bit is set when its counter is 
+/// BufferSize, i.e. it was set in the last BufferSize samples.
+
+template<typename T, unsigned BufferSize>
+struct counting_input_filter
+{
+  static_assert(BufferSize > 0U, "counting_input_filter requires BufferSize > 0");
+
+  static constexpr unsigned c_buffer_size = BufferSize;
+
+  static constexpr unsigned planes_()
+  {
+    unsigned result = 0U;
+    for (unsigned n = BufferSize; n != 0U; n >>= 1U) result++;
+    return result;
+  }
+
+  static constexpr unsigned c_planes = planes_();
+
+  /// step: shift p_input (already masked) into counters, returns the bits
+  /// whose counter is saturated
+  static T step(T* p_count, const std::size_t p_stride, const T p_input)
+  {
+    // saturated counters are not incremented
+    T saturated = T(~T(0U));
+    for (unsigned k = 0U; k < c_planes; k++)
+    {
+      const T plane = p_count[k * p_stride];
+      saturated &= ((BufferSize >> k) & 1U) ? plane : T(~plane);
+    }
+
+    T carry   = T(p_input & ~saturated);
+    T result  = T(~T(0U));
+    for (unsigned k = 0U; k < c_planes; k++)
+    {
+      const T plane = p_count[k * p_stride];
+      const T next  = T(((plane ^ carry) & p_input));
+      carry         = T(plane & carry);
+      p_count[k * p_stride] = next;
+      result &= ((BufferSize >> k) & 1U) ? next : T(~next);
+    }
+    return result;
+  }
+
+  counting_input_filter(const T p_mask = 0U)
+  : m_mask(p_mask),
+    m_value(0U),
+    m_edge(0U)
+  {
+    std::fill_n(&m_count[0], c_planes, 0U);
+  }
+
+  T operator()(const T      p_input)
+  {
+    T result  = step(&m_count[0], 1U, p_input & m_mask);
+    m_edge    = result ^ m_value;
+    m_value   = result;
+    return m_value;
+  }
+
+  T      value() const
+  {
+    return m_value;
+  }
+
+  T      edge() const
+  {
+    return m_edge;
+  }
+  
+  T mask() const
+  {
+    return m_mask;
+  }
+
+  T      m_count[c_planes];
+  T      m_mask;
+  T      m_value;
+  T      m_edge;
+};
+
+/// Bank of Channels counting_input_filter words filtered together.
+/// State is kept as one array per counter plane, so the per channel loop
+/// has no dependencies between channels and is vectorized by the compiler
+
+template<typename T, unsigned BufferSize, std::size_t Channels>
+struct digital_input_filter_bank
+{
+  typedef counting_input_filter<T, BufferSize> filter_type;
+
+  static constexpr unsigned     c_buffer_size = BufferSize;
+  static constexpr unsigned     c_planes      = filter_type::c_planes;
+  static constexpr std::size_t  c_channels    = Channels;
+
+  digital_input_filter_bank(const T p_mask = 0U)
+  {
+    std::fill_n(&m_count[0][0], c_planes * c_channels, 0U);
+    std::fill_n(&m_mask[0],  c_channels, p_mask);
+    std::fill_n(&m_value[0], c_channels, 0U);
+    std::fill_n(&m_edge[0],  c_channels, 0U);
+  }
+
+  /// filter one sample of all channels, p_inputs holds Channels words
+  void operator()(const T* p_inputs)
+  {
+    for (std::size_t c = 0U; c < c_channels; c++)
+    {
+      const T result = 
+        filter_type::step(&m_count[0][c], c_channels, p_inputs[c] & m_mask[c]);
+      m_edge[c]   = result ^ m_value[c];
+      m_value[c]  = result;
+    }
+  }
+
+  void set_mask(const std::size_t p_channel, const T p_mask)
+  {
+    m_mask[p_channel] = p_mask;
+  }
+
+  const T* values() const
+  {
+    return &m_value[0];
+  }
+
+  const T* edges() const
+  {
+    return &m_edge[0];
+  }
+
+  T      value(const std::size_t p_channel) const
+  {
+    return m_value[p_channel];
+  }
+
+  T      edge(const std::size_t p_channel) const
+  {
+    return m_edge[p_channel];
+  }
+
+  T      m_count[c_planes][c_channels];
+  T      m_mask[c_channels];
+  T      m_value[c_channels];
+  T      m_edge[c_channels];
+};
+
 // HALUJ_DIGITAL_INPUT_FILTER_HPP
 #endif
@@ -0,0 +1,145 @@
+/// \file epoll_reactor.hpp
+/// Waits on many file descriptors, e.g. timerfd timers, with epoll (Linux only)
+/*
+This is free and unencumbered software released into the public domain.
+
+Anyone is free to copy, modify, publish, use, compile, sell, or
+distribute this software, either in source code form or as a compiled
+binary, for any purpose, commercial or non-commercial, and by any
+means.
+
+In jurisdictions that recognize copyright laws, the author or authors
+of this software dedicate any and all copyright interest in the
+software to the public domain. We make this dedication for the benefit
+of the public at large and to the detriment of our heirs and
+successors. We intend this dedication to be an overt act of
+relinquishment in perpetuity of all present and future rights to this
+software under copyright law.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+
+For more information, please refer to <http://unlicense.org>
+*/
+/// \author Selcuk Iyikalender
+/// \date   2026
+
+/*! Basic usage:
+* \code {.cpp}
+* typedef haluj::timer<haluj::timer_implementations::timerfd<>> fd_timer;
+* fd_timer              a, b;
+* haluj::epoll_reactor<> r;
+* r.open();
+* r.add(a.impl_.fd(), &a);
+* r.add(b.impl_.fd(), &b);
+* a.set(std::chrono::milliseconds(10));
+* b.set(std::chrono::seconds(1));
+* for (;;)
+* {
+*   // sleeps until one of the timers expires
+*   r.wait([](void* p) { (*static_cast<fd_timer*>(p))(on_expire); });
+* }
+* \endcode
+* A single timerfd armed for the next deadline of a deadline_scheduler
+* multiplexes any number of timers the same way.
+*/
+
+#ifndef HALUJ_EPOLL_REACTOR_HPP
+#define HALUJ_EPOLL_REACTOR_HPP
+
+#if defined(__linux__)
+
+#include <cerrno>
+#include <cstdint>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace haluj
+{
+
+template<int MaxEvents = 16>
+struct epoll_reactor
+{
+  epoll_reactor()
+  {}
+
+  epoll_reactor(const epoll_reactor& ) = delete;
+
+  epoll_reactor(epoll_reactor&& ) = delete;
+
+  ~epoll_reactor()
+  {
+    close();
+  }
+
+  /// open: create the epoll instance. Returns false on failure
+  bool open()
+  {
+    close();
+    fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    return is_open();
+  }
+
+  void close()
+  {
+    if (is_open())
+    {
+      ::close(fd_);
+      fd_ = -1;
+    }
+  }
+
+  bool is_open() const
+  {
+    return fd_ >= 0;
+  }
+
+  /// add: wait for p_fd to become readable, p_context is passed to the
+  /// wait function
+  bool add(int p_fd, void* p_context, std::uint32_t p_events = EPOLLIN)
+  {
+    epoll_event e = {};
+    e.events    = p_events;
+    e.data.ptr  = p_context;
+    return ::epoll_ctl(fd_, EPOLL_CTL_ADD, p_fd, &e) == 0;
+  }
+
+  bool remove(int p_fd)
+  {
+    return ::epoll_ctl(fd_, EPOLL_CTL_DEL, p_fd, nullptr) == 0;
+  }
+
+  /// wait: block up to p_timeout milliseconds (-1 for no limit) and call
+  /// p_function(context) for each ready descriptor. Returns the number of
+  /// ready descriptors, 0 on timeout or interruption, -1 on error
+  template<typename Function>
+  int wait(Function p_function, int p_timeout = -1)
+  {
+    epoll_event events[MaxEvents];
+    int         result = ::epoll_wait(fd_, events, MaxEvents, p_timeout);
+
+    if (result < 0 && errno == EINTR)
+    {
+      result = 0;
+    }
+    for (int i = 0; i < result; i++)
+    {
+      p_function(events[i].data.ptr);
+    }
+    return result;
+  }
+
+  int fd_ = -1;
+};
+
+} // namespace haluj
+
+#endif // __linux__
+
+#endif // HALUJ_EPOLL_REACTOR_HPP
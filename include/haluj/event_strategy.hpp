@@ -32,6 +32,12 @@ For more information, please refer to <http://unlicense.org>
 #ifndef HALUJ_EVENT_STRATEGY_HPP
 #define HALUJ_EVENT_STRATEGY_HPP
 
+#include <array>
+#include <cstdint>
+#include <utility>
+
+#include "ring_buffer.hpp"
+
 namespace haluj
 {
 
@@ -112,6 +118,126 @@ struct blackboard
   EventType pending_event;
 };
 
+/// Bounded event queue with priority lanes and deferred events.
+/// Lane 0 has the highest priority. Events are processed one at a time 
+/// (run to completion): dispatch takes the next event, steps the machine 
+/// once with it, drops it if no transition consumed it and then takes the
+/// next one. Events raised while an event is being processed are queued,
+/// not lost.
+
+template <typename    EventType,
+          std::size_t Capacity,
+          std::size_t Priorities = 1>
+struct queue
+{
+  typedef EventType                                     event_type;
+  typedef ring_buffer<std::array<event_type, Capacity>> lane_type;
+
+  static constexpr std::size_t c_priorities = Priorities;
+
+  /// test: true if the event being processed is p_event
+  bool test(EventType   p_event) const
+  {
+    return (is_valid && (pending_event == p_event));
+  }
+
+  /// clear: consume the event being processed
+  void clear()
+  {
+    is_valid = false;
+  }
+
+  bool test_and_clear(EventType p_event)
+  {
+    bool result = false;
+    
+    if (test(p_event))
+    {
+      result = true;
+      clear();
+    }
+    
+    return result;
+  }
+
+  /// raise: queue an event, returns false if its lane is full
+  bool raise(EventType p_event, std::size_t p_priority = 0)
+  {
+    return lanes[p_priority].push(p_event);
+  }
+
+  /// defer: postpone the event being processed until recall
+  bool defer()
+  {
+    bool result = is_valid && deferred.push(pending_event);
+    if (result)
+    {
+      clear();
+    }
+    return result;
+  }
+
+  /// recall: move deferred events to the highest priority lane, 
+  /// e.g. on entering a state which can handle them
+  void recall()
+  {
+    while (!deferred.empty() && lanes[0].push(deferred.front()))
+    {
+      deferred.pop();
+    }
+  }
+
+  /// next: take the next event from the highest priority non-empty lane.
+  /// Returns false if there is none
+  bool next()
+  {
+    for (auto& lane : lanes)
+    {
+      if (!lane.empty())
+      {
+        pending_event = lane.front();
+        is_valid      = true;
+        lane.pop();
+        break;
+      }
+    }
+    return is_valid;
+  }
+
+  bool empty() const
+  {
+    bool result = !is_valid;
+    for (const auto& lane : lanes)
+    {
+      result = result && lane.empty();
+    }
+    return result;
+  }
+
+  /// dispatch: process all queued events to completion and return the
+  /// final state. Each event is offered to p_machine once, if it is not 
+  /// consumed by a transition it is dropped
+  template <typename MachineType,
+            typename StateType,
+            typename... Args>
+  StateType dispatch(const MachineType&  p_machine,
+                     StateType           p_state,
+                     Args&&...           args)
+  {
+    while (next())
+    {
+      p_state = p_machine(p_state, args...);
+      clear();
+    }
+    return p_state;
+  }
+
+  lane_type     lanes[Priorities];
+  lane_type     deferred;
+  bool          is_valid = false;
+  EventType     pending_event;
+};
+
 } // namespace strategy
 
 } // namespace haluj
@@ -46,6 +46,7 @@ For more information, please refer to <http://unlicense.org>
 
 #include <cstdint>
 #include <utility>
+#include <iterator>
 
 namespace haluj
 {
@@ -0,0 +1,273 @@
+/// \file mapped_ring_buffer.hpp
+/// A ring buffer whose storage is mapped twice back to back (Linux only)
+/*
+This is free and unencumbered software released into the public domain.
+
+Anyone is free to copy, modify, publish, use, compile, sell, or
+distribute this software, either in source code form or as a compiled
+binary, for any purpose, commercial or non-commercial, and by any
+means.
+
+In jurisdictions that recognize copyright laws, the author or authors
+of this software dedicate any and all copyright interest in the
+software to the public domain. We make this dedication for the benefit
+of the public at large and to the detriment of our heirs and
+successors. We intend this dedication to be an overt act of
+relinquishment in perpetuity of all present and future rights to this
+software under copyright law.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+
+For more information, please refer to <http://unlicense.org>
+*/
+/// \author Selcuk Iyikalender
+/// \date   2026
+
+/*! Basic usage:
+* \code {.cpp}
+* haluj::mapped_ring_buffer<char> rb;
+* if (rb.open(1 << 16))
+* {
+*   auto w = rb.contiguous_write();
+*   auto n = recv(fd, w.begin(), w.size(), 0);
+*   if (n > 0) rb.commit_write(n);
+*
+*   auto r     = rb.contiguous_read();
+*   auto first = r.begin();
+*   if (rule.accept(first, r.end())) rb.commit_read(first - r.begin());
+* }
+* \endcode
+* Since the second mapping aliases the first one, element i and element
+* i + capacity() are the same memory. Any range of up to capacity()
+* elements starting inside the buffer is therefore contiguous.
+*/
+
+#ifndef HALUJ_MAPPED_RING_BUFFER_HPP
+#define HALUJ_MAPPED_RING_BUFFER_HPP
+
+#if defined(__linux__)
+
+#include <cstdint>
+#include <type_traits>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "fragment.hpp"
+
+namespace haluj
+{
+
+template<typename T>
+struct mapped_ring_buffer
+{
+  static_assert(std::is_trivially_copyable<T>::value,
+                "mapped_ring_buffer requires trivially copyable elements");
+
+  typedef T                   base_type;
+  typedef base_type*          iterator;
+  typedef std::size_t         index_type;
+  typedef fragment<iterator>  span_type;
+
+  mapped_ring_buffer()
+  {}
+
+  mapped_ring_buffer(const mapped_ring_buffer& ) = delete;
+
+  mapped_ring_buffer(mapped_ring_buffer&& ) = delete;
+
+  ~mapped_ring_buffer()
+  {
+    close();
+  }
+
+  /// open: map storage for at least p_capacity elements. The storage size
+  /// is rounded up to a multiple of the page size. Returns false on failure
+  bool open(const std::size_t p_capacity)
+  {
+    close();
+
+    const std::size_t page  = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+
+    if ((p_capacity == 0) || (page % sizeof(base_type) != 0))
+    {
+      return false;
+    }
+
+    const std::size_t bytes =
+      ((p_capacity * sizeof(base_type) + page - 1) / page) * page;
+
+    int fd = memfd_create("haluj_mapped_ring_buffer", MFD_CLOEXEC);
+
+    if (fd < 0)
+    {
+      return false;
+    }
+
+    bool  result  = false;
+    void* reserve = MAP_FAILED;
+
+    if (ftruncate(fd, bytes) == 0)
+    {
+      // reserve twice the size, then map the file over both halves
+      reserve = mmap(nullptr, 2 * bytes, PROT_NONE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+
+    if (reserve != MAP_FAILED)
+    {
+      char* base = static_cast<char*>(reserve);
+
+      result =
+        (mmap(base, bytes, PROT_READ | PROT_WRITE,
+              MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED) &&
+        (mmap(base + bytes, bytes, PROT_READ | PROT_WRITE,
+              MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED);
+
+      if (result)
+      {
+        m_data      = reinterpret_cast<iterator>(base);
+        m_capacity  = bytes / sizeof(base_type);
+        clear();
+      }
+      else
+      {
+        munmap(reserve, 2 * bytes);
+      }
+    }
+
+    ::close(fd);
+
+    return result;
+  }
+
+  /// close: release the mapping
+  void close()
+  {
+    if (is_open())
+    {
+      munmap(m_data, 2 * m_capacity * sizeof(base_type));
+      m_data      = nullptr;
+      m_capacity  = 0;
+      clear();
+    }
+  }
+
+  bool is_open() const
+  {
+    return m_data != nullptr;
+  }
+
+  /// clear the buffer
+  void clear()
+  {
+    m_tail  = 0;
+    m_size  = 0;
+  }
+
+  /// capacity: maximum number of elements
+  std::size_t capacity() const
+  {
+    return m_capacity;
+  }
+
+  /// size: how many elements are written/available to read
+  std::size_t size() const
+  {
+    return m_size;
+  }
+
+  /// remaining: remaining free space to write
+  std::size_t remaining() const
+  {
+    return capacity() - size();
+  }
+
+  /// full: returns true if buffer is full
+  bool full() const
+  {
+    return size() == capacity();
+  }
+
+  /// empty: returns true if buffer is empty
+  bool empty() const
+  {
+    return size() == 0;
+  }
+
+  /// push: Add a new element to head. Like ring_buffer with the reject
+  /// policy, returns false and leaves the buffer unchanged if it is full
+  bool push(const base_type &p_data)
+  {
+    bool result = !full();
+    if (result)
+    {
+      m_data[m_tail + m_size] = p_data;
+      m_size++;
+    }
+    return result;
+  }
+
+  /// pop: remove element from the tail
+  void pop()
+  {
+    commit_read(1);
+  }
+
+  base_type& front()
+  {
+    return m_data[m_tail];
+  }
+
+  base_type& back()
+  {
+    return m_data[m_tail + m_size - 1];
+  }
+
+  /// contiguous_read: all written elements as a single range
+  span_type contiguous_read() const
+  {
+    return span_type(m_data + m_tail, m_data + m_tail + m_size);
+  }
+
+  /// contiguous_write: all free space as a single range
+  span_type contiguous_write() const
+  {
+    return span_type(m_data + m_tail + m_size, m_data + m_tail + m_capacity);
+  }
+
+  /// commit_write: publish p_count elements written through
+  /// contiguous_write
+  void commit_write(std::size_t p_count)
+  {
+    m_size += p_count;
+  }
+
+  /// commit_read: remove p_count elements read through contiguous_read
+  void commit_read(std::size_t p_count)
+  {
+    m_tail += p_count;
+    m_size -= p_count;
+    if (m_tail >= m_capacity)
+    {
+      m_tail -= m_capacity;
+    }
+  }
+
+  iterator      m_data      = nullptr;
+  std::size_t   m_capacity  = 0;
+  index_type    m_tail      = 0;
+  std::size_t   m_size      = 0;
+};
+
+} // namespace haluj
+
+#endif // __linux__
+
+#endif // HALUJ_MAPPED_RING_BUFFER_HPP
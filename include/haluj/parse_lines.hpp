@@ -0,0 +1,176 @@
+/// \file parse_lines.hpp
+/// Parallel parsing of newline delimited records
+/*
+This is free and unencumbered software released into the public domain.
+
+Anyone is free to copy, modify, publish, use, compile, sell, or
+distribute this software, either in source code form or as a compiled
+binary, for any purpose, commercial or non-commercial, and by any
+means.
+
+In jurisdictions that recognize copyright laws, the author or authors
+of this software dedicate any and all copyright interest in the
+software to the public domain. We make this dedication for the benefit
+of the public at large and to the detriment of our heirs and
+successors. We intend this dedication to be an overt act of
+relinquishment in perpetuity of all present and future rights to this
+software under copyright law.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+
+For more information, please refer to <http://unlicense.org>
+*/
+/// \author Selcuk Iyikalender
+/// \date   2026
+
+/*! Basic usage:
+* \code {.cpp}
+* struct record { unsigned id; std::string_view name; };
+*
+* auto records = haluj::parse_lines<record>(haluj::fragment<const char*>(first, last),
+*   [](haluj::fragment<const char*> line, record& r)
+*   {
+*     auto f = line.begin();
+*     return seq(uint_(r.id), ch(','), span_(rest(), r.name)).accept(f, line.end());
+*   });
+* \endcode
+* The input (e.g. a memory mapped file) is split into one chunk per thread
+* at newline boundaries, lines are passed as fragments pointing into the
+* input, so nothing is copied. Each thread collects the results of its
+* chunk, chunks are joined in input order. The line function must be safe
+* to call concurrently; rules built inside it (as above) are.
+*/
+
+#ifndef HALUJ_PARSE_LINES_HPP
+#define HALUJ_PARSE_LINES_HPP
+
+#include <cstdint>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include "char_search.hpp"
+#include "fragment.hpp"
+
+namespace haluj
+{
+
+/// chunks smaller than this are not worth a thread
+constexpr std::size_t c_parse_lines_min_chunk = 1 << 16;
+
+/// for_each_line: call p_function for each line in [first, last). Lines
+/// are separated by '\n' which is not included. A last line without a
+/// terminating newline is passed if not empty
+template<typename LineFunction>
+void for_each_line(const char* first, const char* last, LineFunction p_function)
+{
+  while (first != last)
+  {
+    const char* eol = find_char(first, last, '\n');
+    p_function(fragment<const char*>(first, eol));
+    first = (eol != last) ? eol + 1 : last;
+  }
+}
+
+/// parse_lines: call p_function(line, result) for each line of p_input
+/// using up to p_threads threads (0 for hardware concurrency). Results of
+/// lines for which p_function returns true are returned in input order.
+/// result is value initialized before each call, so a line that fails
+/// half way through does not leak into the next one. If p_function 
+/// throws, its chunk stops, all threads are joined and the exception of
+/// the first such chunk is rethrown
+template<typename ResultType, typename LineFunction>
+std::vector<ResultType> parse_lines(const fragment<const char*>& p_input,
+                                    LineFunction                 p_function,
+                                    unsigned                     p_threads = 0)
+{
+  typedef std::vector<ResultType> results_type;
+
+  const std::size_t size = p_input.size();
+
+  if (p_threads == 0)
+  {
+    p_threads = std::thread::hardware_concurrency();
+  }
+
+  std::size_t chunk_count = size / c_parse_lines_min_chunk;
+  if (chunk_count > p_threads) chunk_count = p_threads;
+  if (chunk_count == 0)        chunk_count = 1;
+
+  // chunk i is [bounds[i], bounds[i + 1]), each boundary follows a newline
+  std::vector<const char*> bounds(chunk_count + 1, p_input.end());
+  bounds[0] = p_input.begin();
+  for (std::size_t i = 1; i < chunk_count; i++)
+  {
+    const char* split = p_input.begin() + i * (size / chunk_count);
+    if (split < bounds[i - 1]) split = bounds[i - 1];
+    split     = find_char(split, p_input.end(), '\n');
+    bounds[i] = (split != p_input.end()) ? split + 1 : split;
+  }
+
+  std::vector<results_type>       results(chunk_count);
+  std::vector<std::exception_ptr> errors(chunk_count);
+
+  auto work = 
+    [&](const std::size_t i)
+    {
+      try
+      {
+        ResultType value;
+        for_each_line(bounds[i], bounds[i + 1], 
+                      [&](const fragment<const char*>& line)
+                      {
+                        value = ResultType();
+                        if (p_function(line, value))
+                        {
+                          results[i].push_back(value);
+                        }
+                      });
+      }
+      catch (...)
+      {
+        errors[i] = std::current_exception();
+      }
+    };
+
+  std::vector<std::thread> threads;
+  threads.reserve(chunk_count - 1);
+  for (std::size_t i = 1; i < chunk_count; i++)
+  {
+    threads.emplace_back(work, i);
+  }
+  work(0);
+  for (auto &t : threads)
+  {
+    t.join();
+  }
+
+  for (const auto &e : errors)
+  {
+    if (e)
+    {
+      std::rethrow_exception(e);
+    }
+  }
+
+  std::size_t total = 0;
+  for (const auto &r : results) total += r.size();
+
+  results_type result;
+  result.reserve(total);
+  for (auto &r : results)
+  {
+    result.insert(result.end(), r.begin(), r.end());
+  }
+  return result;
+}
+
+} // namespace haluj
+
+#endif // HALUJ_PARSE_LINES_HPP
@@ -32,12 +32,84 @@ For more information, please refer to <http://unlicense.org>
 #ifndef HALUJ_PARSER_HPP
 #define HALUJ_PARSER_HPP
 
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "char_class.hpp"
+#include "char_search.hpp"
+
 namespace haluj
 {
 
 struct rule
 {};
 
+/// never_fails: true for rules which always accept (e.g. opt, zm)
+template<typename ExprType>
+struct never_fails;
+
+/// atomic_failure: true for rules which leave first unchanged on failure
+template<typename ExprType>
+struct atomic_failure;
+
+/// Character class parser rule
+/// parses a single character in one of the classes of Mask (C locale).
+/// om and zm over a character class rule scan contiguous char input in bulk
+
+template<char_class::mask_type Mask>
+struct char_class_p : rule
+{
+  static constexpr char_class::mask_type mask = Mask;
+
+  template<typename Iterator>
+  bool accept(Iterator &first, Iterator last) const
+  {
+    bool result = (first != last && char_class::test<Mask>(*first));
+    if (result) first++;
+    return result;
+  }
+};
+
+template<char_class::mask_type Mask>
+std::integral_constant<char_class::mask_type, Mask> 
+char_class_of_(const char_class_p<Mask>*);
+
+std::integral_constant<char_class::mask_type, 0> 
+char_class_of_(const void*);
+
+/// char_class_of: Mask of character class rules, 0 for other rules
+template<typename ExprType>
+using char_class_of = 
+  decltype(char_class_of_(static_cast<const ExprType*>(nullptr)));
+
+/// is_char_pointer: true for char* and const char* 
+template<typename Iterator>
+using is_char_pointer = 
+  std::integral_constant
+  <
+    bool, 
+    std::is_pointer<Iterator>::value && 
+    std::is_same<std::remove_cv_t<std::remove_pointer_t<Iterator>>, char>::value
+  >;
+
+/// true if ExprType is a character class rule that can be scanned in bulk
+template<typename ExprType, typename Iterator>
+using is_bulk_scannable = 
+  std::integral_constant
+  <
+    bool, 
+    (char_class_of<ExprType>::value != 0) && is_char_pointer<Iterator>::value
+  >;
+
 /// Specific character parser rule
 /// parses a single alphabethic character defined in C locale
 
@@ -65,22 +137,57 @@ inline ch_p ch(const char c)
   return ch_p(c);
 }
 
-/// Alphabetic parser rule
-/// parses a single alphabethic character defined in C locale
+/// Literal string parser rule
+/// parses the characters of a string. The string is not copied, it must
+/// outlive the rule (string literals do)
 
-struct alpha_p : rule
+struct lit_p : rule
 {
-  alpha_p()
-  {}
+  lit_p(const char* s, const std::size_t n)
+  : s_(s), n_(n) {}
 
   template<typename Iterator>
   bool accept(Iterator &first, Iterator last) const
   {
-    bool result = (first != last && (isalpha(*first) != 0));
-    if (result) first++;
+    bool result = false;
+    if constexpr (is_char_pointer<Iterator>::value)
+    {
+      result = (std::size_t(last - first) >= n_) && 
+               (std::memcmp(first, s_, n_) == 0);
+      if (result) first += n_;
+    }
+    else
+    {
+      Iterator    initial = first;
+      const char* s       = s_;
+      while((s != s_ + n_) && (first != last) && (*first == *s))
+      {
+        first++;
+        s++;
+      }
+      result = (s == s_ + n_);
+      if (!result)
+        first = initial;
+    }
     return result;
   }
 
+  const char* s_;
+  std::size_t n_;
+};
+
+inline lit_p lit(const char* s)
+{
+  return lit_p(s, std::strlen(s));
+}
+
+/// Alphabetic parser rule
+/// parses a single alphabethic character defined in C locale
+
+struct alpha_p : char_class_p<char_class::alpha>
+{
+  alpha_p()
+  {}
 };
 
 inline alpha_p alpha()
@@ -91,19 +198,10 @@ inline alpha_p alpha()
 /// Alphabetic parser rule
 /// parses a single alphabethic character defined in C locale
 
-struct alnum_p : rule
+struct alnum_p : char_class_p<char_class::alnum>
 {
   alnum_p()
   {}
-
-  template<typename Iterator>
-  bool accept(Iterator &first, Iterator last) const
-  {
-    bool result = (first != last && (isalnum(*first) != 0));
-    if (result) first++;
-    return result;
-  }
-
 };
 
 inline alnum_p alnum()
@@ -113,22 +211,10 @@ inline alnum_p alnum()
 
 /// Whitespace parser rule (including eol)
 
-struct space_p : rule
+struct space_p : char_class_p<char_class::space>
 {
   space_p()
   {}
-
-  template<typename Iterator>
-  bool accept(Iterator &first, Iterator last) const
-  {
-    bool result = (first != last && (isspace(*first) != 0));
-    if (result)
-    {
-      first++;
-    }
-    return result;
-  }
-
 };
 
 inline space_p space()
@@ -139,99 +225,370 @@ inline space_p space()
 /// Single digit parser rule
 /// parses a single digit
 
-struct digit_p : rule
+struct digit_p : char_class_p<char_class::digit>
 {
   digit_p()
   {}
+};
+
+inline digit_p digit()
+{
+  return digit_p();
+}
+
+/// Single hex digit parser rule
+/// parses a single digit
+
+struct hex_digit_p : char_class_p<char_class::hex_digit>
+{
+  hex_digit_p()
+  {}
+};
+
+inline hex_digit_p hex_digit()
+{
+  return hex_digit_p();
+}
+
+/// Upper case parser rule
+/// parses a single upper case alpha character defined in C locale
+
+struct upper_p : char_class_p<char_class::upper>
+{
+  upper_p()
+  {}
+};
+
+inline upper_p upper()
+{
+  return upper_p();
+}
+
+/// rest parser
+/// consumes all remaining characters to end of the buffer
+/// typical this rule is useful for parsing line comments
+
+struct rest_p : rule
+{
+  rest_p()
+  {}
 
   template<typename Iterator>
   bool accept(Iterator &first, Iterator last) const
   {
-    bool result = (first != last && (isdigit(*first) != 0));
-    if (result)
+    while(first != last) first++;
+    return true;
+  }
+
+};
+
+inline rest_p rest()
+{
+  return rest_p();
+}
+
+/// Unsigned integer parser rule
+/// parses decimal digits into out, fails without consuming on overflow
+
+template<typename T>
+struct uint_p : rule
+{
+  static_assert(std::is_unsigned<T>::value, "uint_ requires an unsigned type");
+
+  uint_p(T& out)
+  : out_(&out) {}
+
+  /// accumulate_: digits in base Base while value fits in p_limit
+  template<unsigned Base, typename Iterator>
+  static bool accumulate_(Iterator &first, Iterator last, T& p_value, const T p_limit)
+  {
+    Iterator  initial = first;
+    bool      result  = true;
+    T         value   = 0;
+    for (; first != last; ++first)
     {
-      first++;
+      unsigned        d;
+      const unsigned  c = static_cast<unsigned char>(*first);
+      if (c - '0' < 10u)
+        d = c - '0';
+      else if ((Base == 16) && ((c | 0x20u) - 'a' < 6u))
+        d = (c | 0x20u) - 'a' + 10;
+      else
+        break;
+      if (value > (p_limit - d) / Base)
+      {
+        result = false;
+        break;
+      }
+      value = T(value * Base + d);
     }
+    result = result && (first != initial);
+    if (result)
+      p_value = value;
+    else
+      first = initial;
     return result;
   }
 
+  template<typename Iterator>
+  bool accept(Iterator &first, Iterator last) const
+  {
+    return accumulate_<10>(first, last, *out_, std::numeric_limits<T>::max());
+  }
+
+  T* out_;
 };
 
-inline digit_p digit()
+template<typename T>
+inline uint_p<T> uint_(T& out)
 {
-  return digit_p();
+  return uint_p<T>(out);
 }
 
-/// Single hex digit parser rule
-/// parses a single digit
+/// Hexadecimal integer parser rule
+/// parses hex digits (without prefix) into out, fails on overflow
 
-struct hex_digit_p : rule
+template<typename T>
+struct hex_p : rule
 {
-  hex_digit_p()
-  {}
+  static_assert(std::is_unsigned<T>::value, "hex_ requires an unsigned type");
+
+  hex_p(T& out)
+  : out_(&out) {}
 
   template<typename Iterator>
   bool accept(Iterator &first, Iterator last) const
   {
-    bool result = (first != last && (isxdigit(*first) != 0));
-    if (result)
+    return 
+      uint_p<T>::template accumulate_<16>(first, last, *out_, 
+                                          std::numeric_limits<T>::max());
+  }
+
+  T* out_;
+};
+
+template<typename T>
+inline hex_p<T> hex_(T& out)
+{
+  return hex_p<T>(out);
+}
+
+/// Signed integer parser rule
+/// parses an optional sign and decimal digits into out, fails on overflow
+
+template<typename T>
+struct int_p : rule
+{
+  static_assert(std::is_signed<T>::value && std::is_integral<T>::value, 
+                "int_ requires a signed integer type");
+
+  typedef std::make_unsigned_t<T> unsigned_type;
+
+  int_p(T& out)
+  : out_(&out) {}
+
+  template<typename Iterator>
+  bool accept(Iterator &first, Iterator last) const
+  {
+    Iterator      initial   = first;
+    bool          negative  = false;
+    unsigned_type magnitude = 0;
+
+    if (first != last && (*first == '-' || *first == '+'))
     {
-      first++;
+      negative = (*first == '-');
+      ++first;
     }
+
+    const unsigned_type limit = 
+      unsigned_type(std::numeric_limits<T>::max()) + (negative ? 1u : 0u);
+
+    bool result = 
+      uint_p<unsigned_type>::template accumulate_<10>(first, last, magnitude, limit);
+    if (result)
+      *out_ = negative ? T(unsigned_type(0) - magnitude) : T(magnitude);
+    else
+      first = initial;
     return result;
   }
 
+  T* out_;
 };
 
-inline hex_digit_p hex_digit()
+template<typename T>
+inline int_p<T> int_(T& out)
 {
-  return hex_digit_p();
+  return int_p<T>(out);
 }
 
-/// Upper case parser rule
-/// parses a single upper case alpha character defined in C locale
+/// Floating point parser rule
+/// parses [+-]digits[.digits][(e|E)[+-]digits] into out, at least one 
+/// mantissa digit is required. Fails without consuming if the value is out
+/// of range. Values with up to 15 significant digits and small exponents 
+/// are converted exactly while scanning; others are rounded correctly by 
+/// std::from_chars on char pointers and approximated otherwise
 
-struct upper_p : rule
+template<typename T>
+struct float_p : rule
 {
-  upper_p()
-  {}
+  static_assert(std::is_floating_point<T>::value, "float_ requires a floating point type");
+
+  float_p(T& out)
+  : out_(&out) {}
 
   template<typename Iterator>
   bool accept(Iterator &first, Iterator last) const
   {
-    bool result = (first != last && (isupper(*first) != 0));
-    if (result) first++;
+    static constexpr double c_pow10[] =
+    {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    Iterator      initial   = first;
+    bool          negative  = false;
+    std::uint64_t mantissa  = 0;
+    int           digits    = 0;  // significant digits in mantissa
+    int           exponent  = 0;
+    bool          any_digit = false;
+
+    if (first != last && (*first == '-' || *first == '+'))
+    {
+      negative = (*first == '-');
+      ++first;
+    }
+
+    for (bool fraction = false; first != last; ++first)
+    {
+      const unsigned d = static_cast<unsigned char>(*first) - unsigned('0');
+      if (d < 10u)
+      {
+        any_digit = true;
+        if (digits < 19)
+        {
+          mantissa = mantissa * 10 + d;
+          digits  += (mantissa != 0) ? 1 : 0;
+          exponent -= fraction ? 1 : 0;
+        }
+        else
+        {
+          exponent += fraction ? 0 : 1;
+        }
+      }
+      else if (*first == '.' && !fraction)
+        fraction = true;
+      else
+        break;
+    }
+
+    if (!any_digit)
+    {
+      first = initial;
+      return false;
+    }
+
+    if (first != last && (*first == 'e' || *first == 'E'))
+    {
+      Iterator  mark          = first;
+      bool      negative_e    = false;
+      unsigned  e             = 0;
+      ++first;
+      if (first != last && (*first == '-' || *first == '+'))
+      {
+        negative_e = (*first == '-');
+        ++first;
+      }
+      if (first == last || !char_class::test<char_class::digit>(*first))
+      {
+        first = mark;
+      }
+      else if (uint_p<unsigned>::template accumulate_<10>(first, last, e, 99999))
+      {
+        exponent += negative_e ? -int(e) : int(e);
+      }
+      else
+      {
+        first = initial;
+        return false;
+      }
+    }
+
+    T     value   = 0;
+    bool  result  = true;
+    if (mantissa == 0)
+    {
+      value = 0;
+    }
+    else if (digits <= 15 && exponent >= -22 && exponent <= 22)
+    {
+      double v = double(mantissa);
+      v = (exponent < 0) ? v / c_pow10[-exponent] : v * c_pow10[exponent];
+      value = T(v);
+    }
+    else
+    {
+#if defined(__cpp_lib_to_chars)
+      if constexpr (is_char_pointer<Iterator>::value)
+      {
+        const char* text = initial + ((*initial == '+') ? 1 : 0);
+        auto r = std::from_chars(text, first, value);
+        result = (r.ec == std::errc()) && (r.ptr == first);
+        negative = false;
+      }
+      else
+#endif
+      {
+        value = T(double(mantissa) * std::pow(10.0, exponent));
+      }
+    }
+
+    result = result && std::isfinite(value);
+    if (result)
+      *out_ = negative ? -value : value;
+    else
+      first = initial;
     return result;
   }
 
+  T* out_;
 };
 
-inline upper_p upper()
+template<typename T>
+inline float_p<T> float_(T& out)
 {
-  return upper_p();
+  return float_p<T>(out);
 }
 
-/// rest parser
-/// consumes all remaining characters to end of the buffer
-/// typical this rule is useful for parsing line comments
+/// Span capture rule
+/// stores the characters accepted by ExprType into out without copying.
+/// Only for contiguous char input
 
-struct rest_p : rule
+template<typename ExprType>
+struct span_p : rule
 {
-  rest_p()
-  {}
+  span_p(const ExprType& p_expr, std::string_view& out)
+  : expr_(p_expr), out_(&out) {}
 
   template<typename Iterator>
   bool accept(Iterator &first, Iterator last) const
   {
-    while(first != last) first++;
-    return true;
+    static_assert(is_char_pointer<Iterator>::value, 
+                  "span_ requires char pointer iterators");
+    Iterator  initial = first;
+    bool      result  = expr_.accept(first, last);
+    if (result)
+      *out_ = std::string_view(initial, std::size_t(first - initial));
+    return result;
   }
 
+  ExprType            expr_;
+  std::string_view*   out_;
 };
 
-inline rest_p rest()
+template<typename ExprType>
+inline span_p<ExprType> span_(const ExprType& p_expr, std::string_view& out)
 {
-  return rest_p();
+  return span_p<ExprType>(p_expr, out);
 }
 
 
@@ -269,7 +626,13 @@ struct om_p : rule
   bool accept(Iterator &first, Iterator last) const
   {
     bool result = false;
-    if (expr_.accept(first, last))
+    if constexpr (is_bulk_scannable<ExprType, Iterator>::value)
+    {
+      Iterator initial = first;
+      first   = char_class::scan<char_class_of<ExprType>::value>(first, last);
+      result  = (first != initial);
+    }
+    else if (expr_.accept(first, last))
     {
       result = true;
       while(expr_.accept(first, last));
@@ -297,7 +660,14 @@ struct zm_p : rule
   bool accept(Iterator &first, Iterator last) const
   {
     bool result = true;
-    while(expr_.accept(first, last));
+    if constexpr (is_bulk_scannable<ExprType, Iterator>::value)
+    {
+      first = char_class::scan<char_class_of<ExprType>::value>(first, last);
+    }
+    else
+    {
+      while(expr_.accept(first, last));
+    }
     return result;
   }
 
@@ -310,6 +680,56 @@ zm_p<ExprType> zm(const ExprType& expr)
   return zm_p<ExprType>(expr);
 }
 
+/// Bounded repetition rule
+/// accepts ExprType at least Min and at most Max times, as many as 
+/// possible. Character class rules over contiguous char input are tested
+/// with one bounded scan
+
+constexpr std::size_t c_rep_unbounded = std::numeric_limits<std::size_t>::max();
+
+template<typename ExprType, std::size_t Min, std::size_t Max>
+struct rep_p : rule
+{
+  static_assert(Min <= Max, "rep requires Min <= Max");
+
+  rep_p(const ExprType& expr)
+  : expr_(expr)
+  {}
+
+  template<typename Iterator>
+  bool accept(Iterator &first, Iterator last) const
+  {
+    Iterator    initial = first;
+    std::size_t count   = 0;
+    if constexpr (is_bulk_scannable<ExprType, Iterator>::value)
+    {
+      Iterator limit = 
+        (std::size_t(last - first) > Max) ? first + Max : last;
+      first = 
+        char_class::scan_bounded<char_class_of<ExprType>::value>(first, limit, last);
+      count = std::size_t(first - initial);
+    }
+    else
+    {
+      while((count < Max) && expr_.accept(first, last)) count++;
+    }
+    bool result = (count >= Min);
+    if (!result)
+      first = initial;
+    return result;
+  }
+
+  ExprType expr_;
+};
+
+/// rep<N>(rule) accepts exactly N times, rep<Min, Max>(rule) between Min
+/// and Max times, Max may be c_rep_unbounded
+template<std::size_t Min, std::size_t Max = Min, typename ExprType>
+rep_p<ExprType, Min, Max> rep(const ExprType& expr)
+{
+  return rep_p<ExprType, Min, Max>(expr);
+}
+
 template<typename ... Types>
 struct seq_p : rule
 {
@@ -332,11 +752,20 @@ struct seq_p<ExprType, Types...> : rule
   template<typename Iterator>
   bool accept(Iterator &first, Iterator last) const
   {
-    Iterator initial = first;
-    bool result = (expr_.accept(first, last) && next_.accept(first, last));
-    if (!result)
-      first = initial;
-    return result;
+    if constexpr (atomic_failure<ExprType>::value && 
+                  (never_fails<Types>::value && ...))
+    {
+      // only the first rule can fail and it restores first by itself
+      return expr_.accept(first, last) && next_.accept(first, last);
+    }
+    else
+    {
+      Iterator initial = first;
+      bool result = (expr_.accept(first, last) && next_.accept(first, last));
+      if (!result)
+        first = initial;
+      return result;
+    }
   }
 
   ExprType  expr_;
@@ -403,19 +832,193 @@ any(const ExprType& p_a, Types... args)
   return any_p<ExprType, Types...>(p_a, args...);
 }
 
-//
+/// is_literal: true for ch_p and lit_p
 template<typename ExprType>
-struct except_p : rule
+using is_literal = 
+  std::integral_constant
+  <
+    bool, 
+    std::is_same<ExprType, ch_p>::value || std::is_same<ExprType, lit_p>::value
+  >;
+
+/// any over ch_p and lit_p alternatives, built with any_dispatch(...)
+/// Alternatives are indexed by their first character at construction, so
+/// accept only tries the ones which can match the next character. Order of
+/// the alternatives is preserved, the first one accepting wins as in any_p.
+/// The index is a 256 entry table, use it for alternations over many 
+/// keywords; any() stays a plain any_p
+
+template<typename ... Types>
+struct any_dispatch_p : rule
 {
-  except_p(const ExprType& expr)
-  : expr_(expr)
-  {}
+  static constexpr std::size_t c_count = sizeof...(Types);
 
-  template<typename Iterator>
-  bool accept(Iterator &first, Iterator last) const
-  {
-    Iterator initial = first;
-    while((first != last) && !expr_.accept(first, last)) first++;
+  static_assert((is_literal<Types>::value && ...), 
+                "any_dispatch_p alternatives must be ch_p or lit_p");
+
+  static_assert(c_count <= 64, "any_dispatch_p supports up to 64 alternatives");
+
+  typedef
+    std::conditional_t<(c_count <= 8),  std::uint8_t,
+    std::conditional_t<(c_count <= 16), std::uint16_t,
+    std::conditional_t<(c_count <= 32), std::uint32_t, std::uint64_t>>> 
+    mask_type;
+
+  any_dispatch_p(Types... args)
+  : exprs_(args...)
+  {
+    build_(std::index_sequence_for<Types...>());
+  }
+
+  template<typename Iterator>
+  bool accept(Iterator &first, Iterator last) const
+  {
+    typedef bool (*accept_type)(const any_dispatch_p&, Iterator&, Iterator);
+
+    static constexpr std::array<accept_type, c_count> c_accept =
+      accept_table_<Iterator>(std::index_sequence_for<Types...>());
+
+    mask_type m = 
+      (first != last) ? table_[static_cast<unsigned char>(*first)] : end_mask_;
+
+    for (; m != 0; m &= mask_type(m - 1))
+    {
+      if (c_accept[lowest_(m)](*this, first, last)) return true;
+    }
+    return false;
+  }
+
+  std::tuple<Types...>              exprs_;
+  std::array<mask_type, 256>        table_    = {};
+  mask_type                         end_mask_ = 0;
+
+private:
+
+  static bool first_of_(const ch_p& p_expr, char& c)
+  {
+    c = p_expr.c_;
+    return true;
+  }
+
+  static bool first_of_(const lit_p& p_expr, char& c)
+  {
+    c = (p_expr.n_ != 0) ? p_expr.s_[0] : '\0';
+    return p_expr.n_ != 0;
+  }
+
+  template<std::size_t Index>
+  void add_()
+  {
+    const mask_type bit = mask_type(mask_type(1) << Index);
+    char            c;
+    if (first_of_(std::get<Index>(exprs_), c))
+    {
+      table_[static_cast<unsigned char>(c)] |= bit;
+    }
+    else
+    {
+      // empty literal accepts everywhere
+      for (auto &entry : table_) entry |= bit;
+      end_mask_ |= bit;
+    }
+  }
+
+  template<std::size_t ... Indices>
+  void build_(std::index_sequence<Indices...>)
+  {
+    (add_<Indices>(), ...);
+  }
+
+  template<std::size_t Index, typename Iterator>
+  static bool accept_(const any_dispatch_p& p_self, Iterator& first, Iterator last)
+  {
+    return std::get<Index>(p_self.exprs_).accept(first, last);
+  }
+
+  template<typename Iterator, std::size_t ... Indices>
+  static constexpr 
+  std::array<bool (*)(const any_dispatch_p&, Iterator&, Iterator), c_count>
+  accept_table_(std::index_sequence<Indices...>)
+  {
+    return {{ &accept_<Indices, Iterator>... }};
+  }
+
+  static unsigned lowest_(const mask_type m)
+  {
+    if constexpr (sizeof(mask_type) > sizeof(unsigned))
+      return unsigned(__builtin_ctzll(m));
+    else
+      return unsigned(__builtin_ctz(m));
+  }
+};
+
+template<typename ... Types>
+any_dispatch_p<Types...>
+any_dispatch(Types... args)
+{
+  return any_dispatch_p<Types...>(args...);
+}
+
+/// first_char_traits: rules which can only match starting with a character
+/// known at construction. except and except_2 use it to jump to candidate 
+/// positions with a character search over contiguous char input
+
+template<typename ExprType>
+struct first_char_traits : std::false_type
+{};
+
+template<>
+struct first_char_traits<ch_p> : std::true_type
+{
+  static char first(const ch_p& p_expr)
+  {
+    return p_expr.c_;
+  }
+};
+
+/// lit_p must not be empty to be used as a terminator
+template<>
+struct first_char_traits<lit_p> : std::true_type
+{
+  static char first(const lit_p& p_expr)
+  {
+    return p_expr.s_[0];
+  }
+};
+
+template<typename ExprType, typename ... Types>
+struct first_char_traits<seq_p<ExprType, Types...>> 
+: first_char_traits<ExprType>
+{
+  static char first(const seq_p<ExprType, Types...>& p_expr)
+  {
+    return first_char_traits<ExprType>::first(p_expr.expr_);
+  }
+};
+
+//
+template<typename ExprType>
+struct except_p : rule
+{
+  except_p(const ExprType& expr)
+  : expr_(expr)
+  {}
+
+  template<typename Iterator>
+  bool accept(Iterator &first, Iterator last) const
+  {
+    Iterator initial = first;
+    if constexpr (first_char_traits<ExprType>::value && 
+                  is_char_pointer<Iterator>::value)
+    {
+      const char c = first_char_traits<ExprType>::first(expr_);
+      while((first = find_char(first, last, c)) != last && 
+            !expr_.accept(first, last)) first++;
+    }
+    else
+    {
+      while((first != last) && !expr_.accept(first, last)) first++;
+    }
     return (first != last) && (first != initial);
   }
 
@@ -443,8 +1046,30 @@ struct except_2_p : rule
   {
     Iterator  initial = first;
     bool      success = false;
-    while((esc_expr_.accept(first, last) && expr_.accept(first, last) ) || 
-          (!(success = expr_.accept(first, last)) && (first != last) && (first++ != 0) ) );
+    if constexpr (std::is_same<ExprType, ch_p>::value &&
+                  std::is_same<EscapeExprType, ch_p>::value &&
+                  is_char_pointer<Iterator>::value)
+    {
+      // an escape skips the following character, the terminator ends
+      const char esc = esc_expr_.c_;
+      while((first = find_either(first, last, esc, expr_.c_)) != last)
+      {
+        if (*first != esc)
+        {
+          first++;
+          success = true;
+          break;
+        }
+        if (++first == last)
+          break;
+        first++;
+      }
+    }
+    else
+    {
+      while((esc_expr_.accept(first, last) && expr_.accept(first, last) ) || 
+            (!(success = expr_.accept(first, last)) && (first != last) && (++first, true) ) );
+    }
     if (!success)
       first = initial;
     return success;
@@ -527,6 +1152,524 @@ action(const ExprType   &p_expr,
 {
   return action_p<ExprType, ActionType>(p_expr, p_action);
 }
+
+/// Memoization table for memo rules (packrat parsing)
+/// Results are kept in a fixed array of Capacity entries indexed by input
+/// offset and rule id, no allocation is done while parsing. When Capacity
+/// is at least (input length + 1) x (number of memo rules) entries never
+/// collide and every memo rule runs at most once per position, otherwise 
+/// colliding entries are overwritten. Call reset with the beginning of the
+/// input before each parse. Iterator must be random access
+
+template<typename Iterator, std::size_t Capacity = 4096>
+struct memo_table
+{
+  typedef std::uint32_t id_type;
+
+  struct entry
+  {
+    std::uint32_t generation;
+    id_type       id;
+    std::size_t   position;
+    std::size_t   end;
+    bool          success;
+  };
+
+  memo_table()
+  {}
+
+  memo_table(const memo_table& ) = delete;
+
+  /// make_id: id for a new memo rule
+  id_type make_id()
+  {
+    return ids_++;
+  }
+
+  /// reset: invalidate all entries and start a parse at p_begin
+  void reset(Iterator p_begin)
+  {
+    begin_ = p_begin;
+    if (++generation_ == 0)
+    {
+      for (auto &e : entries_) e.generation = 0;
+      generation_ = 1;
+    }
+  }
+
+  std::size_t offset(Iterator p_it) const
+  {
+    return std::size_t(p_it - begin_);
+  }
+
+  Iterator at(std::size_t p_offset) const
+  {
+    return begin_ + p_offset;
+  }
+
+  entry& slot(id_type p_id, std::size_t p_position)
+  {
+    return entries_[(p_position * ids_ + p_id) % Capacity];
+  }
+
+  /// find: cached result of rule p_id at p_position, nullptr if none
+  const entry* find(id_type p_id, std::size_t p_position)
+  {
+    const entry& e = slot(p_id, p_position);
+    return (e.generation == generation_ && e.id == p_id && e.position == p_position) ? 
+           &e : nullptr;
+  }
+
+  void store(id_type p_id, std::size_t p_position, std::size_t p_end, bool p_success)
+  {
+    slot(p_id, p_position) = entry{generation_, p_id, p_position, p_end, p_success};
+  }
+
+  std::array<entry, Capacity> entries_    = {};
+  Iterator                    begin_      = Iterator();
+  std::uint32_t               generation_ = 1;
+  id_type                     ids_        = 0;
+};
+
+/// memo rule
+/// caches the result of ExprType per input position in a memo_table. 
+/// Actions inside ExprType are not repeated when the result is reused
+
+template<typename ExprType, typename TableType>
+struct memo_p : rule
+{
+  memo_p(TableType& p_table, const ExprType& p_expr)
+  : expr_(p_expr),
+    table_(&p_table),
+    id_(p_table.make_id())
+  {}
+
+  template<typename Iterator>
+  bool accept(Iterator &first, Iterator last) const
+  {
+    const std::size_t position  = table_->offset(first);
+    bool              result    = false;
+    if (auto e = table_->find(id_, position))
+    {
+      result  = e->success;
+      first   = table_->at(e->end);
+    }
+    else
+    {
+      result = expr_.accept(first, last);
+      table_->store(id_, position, table_->offset(first), result);
+    }
+    return result;
+  }
+
+  ExprType                      expr_;
+  TableType*                    table_;
+  typename TableType::id_type   id_;
+};
+
+template<typename ExprType, typename TableType>
+inline memo_p<ExprType, TableType>
+memo(TableType& p_table, const ExprType& p_expr)
+{
+  return memo_p<ExprType, TableType>(p_table, p_expr);
+}
+
+/// Error context for expect rules
+/// keeps the furthest input offset where an expect rule failed and the id
+/// of that rule. Call reset with the beginning of the input before each
+/// parse, Iterator should be random access for O(1) offsets
+
+template<typename Iterator>
+struct error_context
+{
+  typedef unsigned id_type;
+
+  void reset(Iterator p_begin)
+  {
+    begin_    = p_begin;
+    offset_   = 0;
+    id_       = 0;
+    failed_   = false;
+  }
+
+  /// record: failure of rule p_id at p_position, the first failure at the
+  /// furthest offset is kept
+  void record(Iterator p_position, const id_type p_id)
+  {
+    const std::size_t offset = std::size_t(std::distance(begin_, p_position));
+    if (!failed_ || offset > offset_)
+    {
+      offset_ = offset;
+      id_     = p_id;
+      failed_ = true;
+    }
+  }
+
+  bool failed() const
+  {
+    return failed_;
+  }
+
+  std::size_t offset() const
+  {
+    return offset_;
+  }
+
+  Iterator position() const
+  {
+    return std::next(begin_, offset_);
+  }
+
+  id_type id() const
+  {
+    return id_;
+  }
+
+  Iterator    begin_    = Iterator();
+  std::size_t offset_   = 0;
+  id_type     id_       = 0;
+  bool        failed_   = false;
+};
+
+/// Error context which records nothing. expect rules built with it are 
+/// the bare rules, so error tracking can be compiled out
+struct no_error_context
+{
+  typedef unsigned id_type;
+};
+
+/// expect rule
+/// records a failure of ExprType with its id in the error context. Costs
+/// nothing when ExprType accepts
+
+template<typename ExprType, typename ContextType>
+struct expect_p : rule
+{
+  typedef typename ContextType::id_type id_type;
+
+  expect_p(ContextType& p_context, const id_type p_id, const ExprType& p_expr)
+  : expr_(p_expr),
+    context_(&p_context),
+    id_(p_id)
+  {}
+
+  template<typename Iterator>
+  bool accept(Iterator &first, Iterator last) const
+  {
+    bool result = expr_.accept(first, last);
+    if (!result)
+      context_->record(first, id_);
+    return result;
+  }
+
+  ExprType      expr_;
+  ContextType*  context_;
+  id_type       id_;
+};
+
+template<typename ExprType, typename ContextType>
+inline expect_p<ExprType, ContextType>
+expect(ContextType& p_context, 
+       const typename ContextType::id_type p_id, 
+       const ExprType& p_expr)
+{
+  return expect_p<ExprType, ContextType>(p_context, p_id, p_expr);
+}
+
+template<typename ExprType>
+inline ExprType
+expect(no_error_context& , const no_error_context::id_type , const ExprType& p_expr)
+{
+  return p_expr;
+}
+
+template<typename ExprType>
+struct never_fails : std::false_type
+{};
+
+template<>
+struct never_fails<rest_p> : std::true_type
+{};
+
+template<typename ExprType>
+struct never_fails<opt_p<ExprType>> : std::true_type
+{};
+
+template<typename ExprType>
+struct never_fails<zm_p<ExprType>> : std::true_type
+{};
+
+template<typename ... Types>
+struct never_fails<seq_p<Types...>> 
+: std::bool_constant<(never_fails<Types>::value && ...)>
+{};
+
+template<typename ExprType, typename ActionType>
+struct never_fails<action_p<ExprType, ActionType>> : never_fails<ExprType>
+{};
+
+template<typename ExprType>
+struct atomic_failure 
+: std::bool_constant<never_fails<ExprType>::value || 
+                     (char_class_of<ExprType>::value != 0)>
+{};
+
+template<>
+struct atomic_failure<ch_p> : std::true_type
+{};
+
+template<>
+struct atomic_failure<lit_p> : std::true_type
+{};
+
+template<typename T>
+struct atomic_failure<uint_p<T>> : std::true_type
+{};
+
+template<typename T>
+struct atomic_failure<int_p<T>> : std::true_type
+{};
+
+template<typename T>
+struct atomic_failure<hex_p<T>> : std::true_type
+{};
+
+template<typename T>
+struct atomic_failure<float_p<T>> : std::true_type
+{};
+
+template<typename ... Types>
+struct atomic_failure<seq_p<Types...>> : std::true_type
+{};
+
+template<typename ... Types>
+struct atomic_failure<any_p<Types...>> 
+: std::bool_constant<(atomic_failure<Types>::value && ...)>
+{};
+
+template<typename ... Types>
+struct atomic_failure<any_dispatch_p<Types...>> : std::true_type
+{};
+
+template<typename ExprType>
+struct atomic_failure<om_p<ExprType>> : atomic_failure<ExprType>
+{};
+
+template<typename ExprType, std::size_t Max>
+struct never_fails<rep_p<ExprType, 0, Max>> : std::true_type
+{};
+
+template<typename ExprType, std::size_t Min, std::size_t Max>
+struct atomic_failure<rep_p<ExprType, Min, Max>> : std::true_type
+{};
+
+template<typename ExprType, typename EscapeExprType>
+struct atomic_failure<except_2_p<ExprType, EscapeExprType>> : std::true_type
+{};
+
+template<typename ExprType, typename ActionType>
+struct atomic_failure<action_p<ExprType, ActionType>> : atomic_failure<ExprType>
+{};
+
+template<typename ExprType>
+struct atomic_failure<span_p<ExprType>> : atomic_failure<ExprType>
+{};
+
+template<typename ExprType, typename ContextType>
+struct never_fails<expect_p<ExprType, ContextType>> : never_fails<ExprType>
+{};
+
+template<typename ExprType, typename ContextType>
+struct atomic_failure<expect_p<ExprType, ContextType>> : atomic_failure<ExprType>
+{};
+
+/// normalize: type level rewrite of a rule tree accepting the same input
+/// - nested seq and any are flattened, seq(seq(a, b), c) -> seq(a, b, c)
+/// - nested repetitions collapse, opt(opt(x)) -> opt(x), om(om(x)) -> om(x)
+///   and any mix with zm, or opt with om, gives zm(x)
+/// Rules not listed are kept as they are.
+
+template<typename ExprType>
+ExprType normalize(const ExprType& p_expr)
+{
+  return p_expr;
+}
+
+template<typename ... Types>
+auto normalize(const seq_p<Types...>& p_expr);
+
+template<typename ... Types>
+auto normalize(const any_p<Types...>& p_expr);
+
+template<typename ExprType>
+auto normalize(const opt_p<ExprType>& p_expr);
+
+template<typename ExprType>
+auto normalize(const om_p<ExprType>& p_expr);
+
+template<typename ExprType>
+auto normalize(const zm_p<ExprType>& p_expr);
+
+template<typename ExprType>
+using normalize_t = decltype(normalize(std::declval<const ExprType&>()));
+
+/// elements_: direct children of seq and any as a tuple
+inline std::tuple<> elements_(const seq_p<>& )
+{
+  return std::tuple<>();
+}
+
+template<typename ExprType, typename ... Types>
+std::tuple<ExprType, Types...> elements_(const seq_p<ExprType, Types...>& p_expr)
+{
+  return std::tuple_cat(std::tuple<ExprType>(p_expr.expr_), elements_(p_expr.next_));
+}
+
+inline std::tuple<> elements_(const any_p<>& )
+{
+  return std::tuple<>();
+}
+
+template<typename ExprType, typename ... Types>
+std::tuple<ExprType, Types...> elements_(const any_p<ExprType, Types...>& p_expr)
+{
+  return std::tuple_cat(std::tuple<ExprType>(p_expr.expr_), elements_(p_expr.next_));
+}
+
+/// seq_items_, any_items_: children of a nested rule of the same kind, or
+/// the rule itself
+template<typename ExprType>
+std::tuple<ExprType> seq_items_(const ExprType& p_expr)
+{
+  return std::tuple<ExprType>(p_expr);
+}
+
+template<typename ... Types>
+std::tuple<Types...> seq_items_(const seq_p<Types...>& p_expr)
+{
+  return elements_(p_expr);
+}
+
+template<typename ExprType>
+std::tuple<ExprType> any_items_(const ExprType& p_expr)
+{
+  return std::tuple<ExprType>(p_expr);
+}
+
+template<typename ... Types>
+std::tuple<Types...> any_items_(const any_p<Types...>& p_expr)
+{
+  return elements_(p_expr);
+}
+
+template<typename ... Types>
+auto normalize(const seq_p<Types...>& p_expr)
+{
+  auto items = 
+    std::apply([](const auto& ... e)
+               { return std::tuple_cat(seq_items_(normalize(e))...); },
+               elements_(p_expr));
+  return 
+    std::apply([](const auto& ... e)
+               { return seq_p<std::decay_t<decltype(e)>...>(e...); },
+               items);
+}
+
+template<typename ... Types>
+auto normalize(const any_p<Types...>& p_expr)
+{
+  auto items = 
+    std::apply([](const auto& ... e)
+               { return std::tuple_cat(any_items_(normalize(e))...); },
+               elements_(p_expr));
+  return 
+    std::apply([](const auto& ... e)
+               { return any_p<std::decay_t<decltype(e)>...>(e...); },
+               items);
+}
+
+/// repetition rules over an already normalized ExprType
+template<typename ExprType>
+opt_p<ExprType> opt_of_(const ExprType& p_expr)  { return opt_p<ExprType>(p_expr); }
+template<typename ExprType>
+opt_p<ExprType> opt_of_(const opt_p<ExprType>& p_expr) { return p_expr; }
+template<typename ExprType>
+zm_p<ExprType>  opt_of_(const om_p<ExprType>& p_expr)  { return zm_p<ExprType>(p_expr.expr_); }
+template<typename ExprType>
+zm_p<ExprType>  opt_of_(const zm_p<ExprType>& p_expr)  { return p_expr; }
+
+template<typename ExprType>
+om_p<ExprType>  om_of_(const ExprType& p_expr)         { return om_p<ExprType>(p_expr); }
+template<typename ExprType>
+zm_p<ExprType>  om_of_(const opt_p<ExprType>& p_expr)  { return zm_p<ExprType>(p_expr.expr_); }
+template<typename ExprType>
+om_p<ExprType>  om_of_(const om_p<ExprType>& p_expr)   { return p_expr; }
+template<typename ExprType>
+zm_p<ExprType>  om_of_(const zm_p<ExprType>& p_expr)   { return p_expr; }
+
+template<typename ExprType>
+zm_p<ExprType>  zm_of_(const ExprType& p_expr)         { return zm_p<ExprType>(p_expr); }
+template<typename ExprType>
+zm_p<ExprType>  zm_of_(const opt_p<ExprType>& p_expr)  { return zm_p<ExprType>(p_expr.expr_); }
+template<typename ExprType>
+zm_p<ExprType>  zm_of_(const om_p<ExprType>& p_expr)   { return zm_p<ExprType>(p_expr.expr_); }
+template<typename ExprType>
+zm_p<ExprType>  zm_of_(const zm_p<ExprType>& p_expr)   { return p_expr; }
+
+template<typename ExprType>
+auto normalize(const opt_p<ExprType>& p_expr)
+{
+  return opt_of_(normalize(p_expr.expr_));
+}
+
+template<typename ExprType>
+auto normalize(const om_p<ExprType>& p_expr)
+{
+  return om_of_(normalize(p_expr.expr_));
+}
+
+template<typename ExprType>
+auto normalize(const zm_p<ExprType>& p_expr)
+{
+  return zm_of_(normalize(p_expr.expr_));
+}
+
+template<typename ExprType, std::size_t Min, std::size_t Max>
+auto normalize(const rep_p<ExprType, Min, Max>& p_expr)
+{
+  auto e = normalize(p_expr.expr_);
+  return rep_p<decltype(e), Min, Max>(e);
+}
+
+template<typename ExprType>
+auto normalize(const except_p<ExprType>& p_expr)
+{
+  auto e = normalize(p_expr.expr_);
+  return except_p<decltype(e)>(e);
+}
+
+template<typename ExprType, typename EscapeExprType>
+auto normalize(const except_2_p<ExprType, EscapeExprType>& p_expr)
+{
+  auto e    = normalize(p_expr.expr_);
+  auto esc  = normalize(p_expr.esc_expr_);
+  return except_2_p<decltype(e), decltype(esc)>(e, esc);
+}
+
+template<typename ExprType, typename ActionType>
+auto normalize(const action_p<ExprType, ActionType>& p_expr)
+{
+  auto e = normalize(p_expr.expr_);
+  return action_p<decltype(e), ActionType>(e, p_expr.a_);
+}
+
+template<typename ExprType, typename ContextType>
+auto normalize(const expect_p<ExprType, ContextType>& p_expr)
+{
+  auto e = normalize(p_expr.expr_);
+  return expect_p<decltype(e), ContextType>(*p_expr.context_, p_expr.id_, e);
+}
+
 /*
 This rule can be used for Debug purposes.
 Due to its iostream and std::string dependencies, it is left commented
@@ -0,0 +1,292 @@
+/// \file parser_stream.hpp
+/// Parsing input which arrives in chunks
+/*
+This is free and unencumbered software released into the public domain.
+
+Anyone is free to copy, modify, publish, use, compile, sell, or
+distribute this software, either in source code form or as a compiled
+binary, for any purpose, commercial or non-commercial, and by any
+means.
+
+In jurisdictions that recognize copyright laws, the author or authors
+of this software dedicate any and all copyright interest in the
+software to the public domain. We make this dedication for the benefit
+of the public at large and to the detriment of our heirs and
+successors. We intend this dedication to be an overt act of
+relinquishment in perpetuity of all present and future rights to this
+software under copyright law.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+
+For more information, please refer to <http://unlicense.org>
+*/
+/// \author Selcuk Iyikalender
+/// \date   2026
+
+/*! Basic usage:
+* \code {.cpp}
+* haluj::ring_buffer<std::array<char, 4096>> rb;
+* auto frame = seq(om(alpha()), ch(':'), om(digit()), ch('\n'));
+* // after each received chunk is pushed into rb
+* haluj::parse_result r;
+* while ((r = haluj::parse_stream(frame, rb)) == haluj::parse_result::success)
+* {
+*   // one frame is consumed from rb
+* }
+* if (r == haluj::parse_result::partial) { ... wait for more input }
+* else { ... protocol error }
+* \endcode
+* Input is read in place from the (up to two) contiguous spans of the
+* buffer through segmented_iterator. A parse which reaches the end of the
+* available input may change its result with more input, it is reported
+* as partial and nothing is consumed. The frame is parsed again from its
+* start when the next chunk arrives; since rules keep no state between
+* calls the saved state is just the frame start, i.e. the buffer tail.
+* Actions inside a partial frame may run again on the next attempt.
+* A partial result with a full buffer means the frame does not fit.
+* Parsing again from the frame start costs O(n * k) for a frame of n
+* elements received in k chunks, e.g. quadratic for a large frame read in
+* small recv chunks. When frames end with a delimiter use frame_parser,
+* which only runs the rule once a delimiter has arrived:
+* \code {.cpp}
+* auto parser = haluj::frame_parser(frame, '\n');
+* while ((r = parser(rb)) == haluj::parse_result::success) { ... }
+* \endcode
+*/
+
+#ifndef HALUJ_PARSER_STREAM_HPP
+#define HALUJ_PARSER_STREAM_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+
+#include "fragment.hpp"
+#include "parser.hpp"
+
+namespace haluj
+{
+
+enum class parse_result
+{
+  success,
+  failure,
+  partial
+};
+
+/// Forward iterator over two spans as a single sequence. Equality is
+/// decided by offset; comparing two iterators at the end of input sets
+/// the probe flag, which tells that a rule looked for more input
+
+template<typename Iterator>
+struct segmented_iterator
+{
+  typedef std::forward_iterator_tag                             iterator_category;
+  typedef typename std::iterator_traits<Iterator>::value_type   value_type;
+  typedef std::ptrdiff_t                                        difference_type;
+  typedef typename std::iterator_traits<Iterator>::pointer      pointer;
+  typedef typename std::iterator_traits<Iterator>::reference    reference;
+  typedef fragment<Iterator>                                    span_type;
+
+  segmented_iterator()
+  {}
+
+  segmented_iterator(const span_type&  p_first,
+                     const span_type&  p_second,
+                     const std::size_t p_offset,
+                     bool*             p_probe)
+  : current_(p_first.begin()),
+    first_end_(p_first.end()),
+    second_begin_(p_second.begin()),
+    offset_(p_offset),
+    size_(p_first.size() + p_second.size()),
+    probe_(p_probe)
+  {
+    if (current_ == first_end_)
+    {
+      current_ = second_begin_;
+    }
+  }
+
+  reference operator*() const
+  {
+    return *current_;
+  }
+
+  segmented_iterator& operator++()
+  {
+    ++offset_;
+    if (++current_ == first_end_)
+    {
+      current_ = second_begin_;
+    }
+    return *this;
+  }
+
+  segmented_iterator operator++(int)
+  {
+    segmented_iterator result = *this;
+    ++(*this);
+    return result;
+  }
+
+  bool operator==(const segmented_iterator& p_other) const
+  {
+    bool result = (offset_ == p_other.offset_);
+    if (result && (offset_ == size_) && (probe_ != nullptr))
+    {
+      *probe_ = true;
+    }
+    return result;
+  }
+
+  bool operator!=(const segmented_iterator& p_other) const
+  {
+    return !(*this == p_other);
+  }
+
+  /// offset: number of elements from the beginning of the first span
+  std::size_t offset() const
+  {
+    return offset_;
+  }
+
+  Iterator    current_      = Iterator();
+  Iterator    first_end_    = Iterator();
+  Iterator    second_begin_ = Iterator();
+  std::size_t offset_       = 0;
+  std::size_t size_         = 0;
+  bool*       probe_        = nullptr;
+};
+
+/// parse_spans: parse the input formed by p_first followed by p_second. 
+/// On success p_consumed is set to the number of elements accepted. 
+/// When p_final is true no more input will come, so reaching the end of 
+/// input is not reported as partial
+template<typename RuleType, typename Iterator>
+parse_result parse_spans(const RuleType&           p_rule,
+                         const fragment<Iterator>& p_first,
+                         const fragment<Iterator>& p_second,
+                         std::size_t&              p_consumed,
+                         const bool                p_final = false)
+{
+  bool                          probe   = false;
+  segmented_iterator<Iterator>  first(p_first, p_second, 0, &probe);
+  segmented_iterator<Iterator>  last(p_first, p_second, p_first.size() + p_second.size(), &probe);
+
+  const bool accepted = p_rule.accept(first, last);
+
+  parse_result result = parse_result::partial;
+  if (!probe || p_final)
+  {
+    result      = accepted ? parse_result::success : parse_result::failure;
+    p_consumed  = accepted ? first.offset() : 0;
+  }
+  return result;
+}
+
+/// parse_stream: parse one frame from a buffer providing read_spans and
+/// commit_read (e.g. ring_buffer). Accepted elements are removed from the
+/// buffer on success only
+template<typename RuleType, typename BufferType>
+parse_result parse_stream(const RuleType& p_rule,
+                          BufferType&     p_buffer,
+                          const bool      p_final = false)
+{
+  auto          spans     = p_buffer.read_spans();
+  std::size_t   consumed  = 0;
+  parse_result  result    = 
+    parse_spans(p_rule, spans.first, spans.second, consumed, p_final);
+
+  if (result == parse_result::success)
+  {
+    p_buffer.commit_read(consumed);
+  }
+  return result;
+}
+
+/// Runs parse_stream on frames ending with Delimiter. Received input is
+/// scanned for the delimiter once, the rule runs only when a delimiter
+/// arrived after the last partial parse, so a frame costs O(n) however
+/// it is split. Frames must end with the delimiter; one which also
+/// occurs inside a frame causes one more parse per occurrence, and 
+/// malformed input is reported as failure once a delimiter follows it.
+/// The buffer must only lose elements through this parser or clear()
+template<typename RuleType, typename ValueType>
+struct frame_parser_t
+{
+  frame_parser_t(const RuleType&  p_rule,
+                 const ValueType  p_delimiter)
+  : rule_(p_rule),
+    delimiter_(p_delimiter)
+  {}
+
+  template<typename BufferType>
+  parse_result operator()(BufferType& p_buffer, const bool p_final = false)
+  {
+    auto              spans = p_buffer.read_spans();
+    const std::size_t size  = spans.first.size() + spans.second.size();
+
+    if (scanned_ > size)
+    {
+      // buffer was cleared
+      scanned_ = 0;
+    }
+
+    parse_result result = parse_result::partial;
+    if (p_final || find_(spans.first, spans.second, scanned_))
+    {
+      result = parse_stream(rule_, p_buffer, p_final);
+    }
+    scanned_ = (result == parse_result::partial) ? size : 0;
+    return result;
+  }
+
+  /// reset: forget scanned input, e.g. after the buffer is refilled
+  void reset()
+  {
+    scanned_ = 0;
+  }
+
+  template<typename Iterator>
+  bool find_(const fragment<Iterator>& p_first,
+             const fragment<Iterator>& p_second,
+             std::size_t               p_offset) const
+  {
+    bool result = false;
+    if (p_offset < p_first.size())
+    {
+      result = std::find(p_first.begin() + p_offset, p_first.end(), 
+                         delimiter_) != p_first.end();
+      p_offset = 0;
+    }
+    else
+    {
+      p_offset -= p_first.size();
+    }
+    return result ||
+           (std::find(p_second.begin() + p_offset, p_second.end(), 
+                      delimiter_) != p_second.end());
+  }
+
+  RuleType    rule_;
+  ValueType   delimiter_;
+  std::size_t scanned_  = 0;  // elements known to hold no new delimiter
+};
+
+template<typename RuleType, typename ValueType>
+frame_parser_t<RuleType, ValueType>
+frame_parser(const RuleType& p_rule, const ValueType p_delimiter)
+{
+  return frame_parser_t<RuleType, ValueType>(p_rule, p_delimiter);
+}
+
+} // namespace haluj
+
+#endif // HALUJ_PARSER_STREAM_HPP
@@ -34,19 +34,161 @@ For more information, please refer to <http://unlicense.org>
 
 #include <cstdint>
 #include <algorithm>
+#include <iterator>
+#include <utility>
+#include <atomic>
 
 #include "bit/field.hpp"
 #include "bit/pack.hpp"
 #include "bit/storage.hpp"
 #include "optional.hpp"
 #include "cyclic_index.hpp"
+#include "fragment.hpp"
+#include "container_traits.hpp"
 
 namespace haluj
 {
+
+/// drop_counter: number of elements lost on overflow. It is written only by
+/// the producer and can be read from any context without locking
+
+struct drop_counter
+{
+  drop_counter()
+  : value_(0)
+  {}
+
+  drop_counter(const drop_counter& p_other)
+  : value_(p_other.get())
+  {}
+
+  drop_counter& operator=(const drop_counter& p_other)
+  {
+    value_.store(p_other.get(), std::memory_order_relaxed);
+    return *this;
+  }
+
+  void add(const std::size_t p_count)
+  {
+    value_.store(value_.load(std::memory_order_relaxed) + p_count,
+                 std::memory_order_relaxed);
+  }
+
+  std::size_t get() const
+  {
+    return value_.load(std::memory_order_relaxed);
+  }
+
+  void reset()
+  {
+    value_.store(0, std::memory_order_relaxed);
+  }
+
+  std::atomic<std::size_t>  value_;
+};
+
+namespace overflow
+{
+
+/// reject: push on a full buffer fails and the element is counted as dropped
+
+struct reject
+{
+  template<typename Buffer>
+  static bool push(Buffer& p_buffer, const typename Buffer::base_type& p_data)
+  {
+    bool result = !p_buffer.full();
+    if (result)
+    {
+      p_buffer.push_unchecked_(p_data);
+    }
+    else
+    {
+      p_buffer.m_dropped.add(1);
+    }
+    return result;
+  }
+
+  template<typename Buffer, typename ForwardIterator>
+  static std::size_t push_n(Buffer& p_buffer, ForwardIterator first, ForwardIterator last)
+  {
+    std::size_t n       = std::distance(first, last);
+    std::size_t result  = p_buffer.push_some_(first, n);
+    p_buffer.m_dropped.add(n - result);
+    return result;
+  }
+};
+
+/// overwrite: push on a full buffer drops the oldest element
+
+struct overwrite
+{
+  template<typename Buffer>
+  static bool push(Buffer& p_buffer, const typename Buffer::base_type& p_data)
+  {
+    p_buffer.push_overwrite_(p_data);
+    return true;
+  }
+
+  template<typename Buffer, typename ForwardIterator>
+  static std::size_t push_n(Buffer& p_buffer, ForwardIterator first, ForwardIterator last)
+  {
+    std::size_t n     = std::distance(first, last);
+    // only the newest capacity elements can survive
+    std::size_t skip  = (n > p_buffer.capacity()) ? (n - p_buffer.capacity()) : 0;
+    std::size_t m     = n - skip;
+    std::size_t older = (m > p_buffer.remaining()) ? (m - p_buffer.remaining()) : 0;
+
+    p_buffer.commit_read(older);
+    p_buffer.push_some_(std::next(first, skip), m);
+    p_buffer.m_dropped.add(skip + older);
+    return n;
+  }
+};
+
+/// block: push on a full buffer calls DrainFunction with the buffer until
+/// it has made room, e.g. by transmitting and popping elements. The buffer
+/// is plain data, so the drain runs in the pushing context; use 
+/// concurrent::spsc_ring_buffer to wait for a consumer in another thread
+
+template<typename DrainFunction>
+struct block
+{
+  template<typename Buffer>
+  static bool push(Buffer& p_buffer, const typename Buffer::base_type& p_data)
+  {
+    while (p_buffer.full()) DrainFunction()(p_buffer);
+    p_buffer.push_unchecked_(p_data);
+    return true;
+  }
+
+  template<typename Buffer, typename ForwardIterator>
+  static std::size_t push_n(Buffer& p_buffer, ForwardIterator first, ForwardIterator last)
+  {
+    std::size_t n     = std::distance(first, last);
+    std::size_t done  = 0;
+
+    while (done < n)
+    {
+      while (p_buffer.full()) DrainFunction()(p_buffer);
+      done += p_buffer.push_some_(std::next(first, done), n - done);
+    }
+    return n;
+  }
+};
+
+} // namespace overflow
+
 /// This is a ring buffer implementation.
+/// OverflowPolicy selects what push does on a full buffer, see overflow
+/// namespace. Containers with a compile time power of two capacity (see
+/// static_capacity) select the mask indexed specialization below.
 
 template< typename  RandomAccessContainerType, 
-          typename  FlagsBaseType  = uint8_t>
+          typename  FlagsBaseType  = uint8_t,
+          typename  OverflowPolicy = overflow::reject,
+          bool      PowerOfTwo     = 
+            is_power_of_two(static_capacity<RandomAccessContainerType>::value)>
 struct ring_buffer
 {
   typedef RandomAccessContainerType             container_type;
@@ -54,6 +196,9 @@ struct ring_buffer
   typedef base_type*                            iterator;
   typedef std::size_t                           index_type;
   typedef FlagsBaseType                         flags_base_type;
+  typedef fragment<iterator>                    span_type;
+  typedef std::pair<span_type, span_type>       spans_type;
+  typedef OverflowPolicy                        overflow_policy;
 
   struct empty_bit  : bit::field<0> {};
   struct full_bit   : bit::field<1> {};
@@ -92,24 +237,9 @@ struct ring_buffer
   /// size: how many elements are written/available to read
   std::size_t size() const
   {
-    std::size_t result;
-    
-    if (empty())
-      result = 0;
-    else if (full())
-      result = capacity();
-    else
-    {
-      if (m_head < m_tail)
-      {
-        result = capacity() + m_head - m_tail;
-      }
-      else
-      {
-        result = m_head - m_tail;
-      }
-    }
-    return result;
+    // head is behind tail after wrapping or when the buffer is full
+    const std::size_t wrapped = (m_head < m_tail) | full();
+    return m_head - m_tail + wrapped * capacity();
   }
 
   /// remaining: remaining free space to write
@@ -130,16 +260,17 @@ struct ring_buffer
     return m_flags.template test<empty_bit>(); 
   }
   
-  /// push: Add a new element to head
-  void push(const base_type &p_data)
+  /// push: Add a new element to head. Behaviour on a full buffer is
+  /// defined by the overflow policy. Returns false if element is dropped
+  bool push(const base_type &p_data)
   {
-    m_container[m_head] = p_data;
-    m_head      =   cyclic_increment(m_head, capacity());
-    m_flags.template clear<empty_bit>();
-    if (m_head == m_tail)
-    {
-      m_flags.template set<full_bit>();
-    }
+    return overflow_policy::push(*this, p_data);
+  }
+
+  /// dropped: number of elements lost due to overflow
+  std::size_t dropped() const
+  {
+    return m_dropped.get();
   }
 
   /// pop: remove element from the tail
@@ -160,13 +291,349 @@ struct ring_buffer
 
   base_type& back() 
   {
-    return m_container[m_head - 1];
+    return m_container[cyclic_decrement(m_head, capacity())];
+  }
+
+  /// push_n: Add elements in [first, last) to head. Behaviour on overflow
+  /// is defined by the overflow policy. Returns the number of elements
+  /// accepted
+  template<typename ForwardIterator>
+  std::size_t push_n(ForwardIterator first, ForwardIterator last)
+  {
+    return overflow_policy::push_n(*this, first, last);
+  }
+
+  /// The methods below are used by overflow policies
+
+  void push_unchecked_(const base_type &p_data)
+  {
+    m_container[m_head] = p_data;
+    m_head      =   cyclic_increment(m_head, capacity());
+    m_flags.template clear<empty_bit>();
+    if (m_head == m_tail)
+    {
+      m_flags.template set<full_bit>();
+    }
+  }
+
+  void push_overwrite_(const base_type &p_data)
+  {
+    const std::size_t lost = full();
+
+    m_container[m_head] = p_data;
+    m_head      =   cyclic_increment(m_head, capacity());
+    m_tail      =   lost ? m_head : m_tail;
+    m_flags.template clear<empty_bit>();
+    if (m_head == m_tail)
+    {
+      m_flags.template set<full_bit>();
+    }
+    m_dropped.add(lost);
+  }
+
+  template<typename ForwardIterator>
+  std::size_t push_some_(ForwardIterator first, std::size_t p_count)
+  {
+    std::size_t n     = std::min(p_count, remaining());
+    spans_type  spans = write_spans();
+    std::size_t n0    = std::min(n, spans.first.size());
+
+    std::copy_n(first, n0, spans.first.begin());
+    std::copy_n(std::next(first, n0), n - n0, spans.second.begin());
+    commit_write(n);
+    return n;
+  }
+
+  /// pop_n: Remove up to p_count elements from the tail into out.
+  /// Returns the output iterator past the last element written
+  template<typename OutputIterator>
+  OutputIterator pop_n(OutputIterator out, std::size_t p_count)
+  {
+    std::size_t n     = std::min(p_count, size());
+    spans_type  spans = read_spans();
+    std::size_t n0    = std::min(n, spans.first.size());
+
+    out = std::copy_n(spans.first.begin(), n0, out);
+    out = std::copy_n(spans.second.begin(), n - n0, out);
+    commit_read(n);
+    return out;
+  }
+
+  /// pop_n: Remove all elements into out
+  template<typename OutputIterator>
+  OutputIterator pop_n(OutputIterator out)
+  {
+    return pop_n(out, size());
+  }
+
+  /// read_spans: contiguous ranges of written elements, tail to wrap point
+  /// and after the wrap point. Use commit_read to remove consumed elements
+  spans_type read_spans()
+  {
+    iterator    d       = data();
+    bool        wrapped = (m_head <= m_tail) && !empty();
+    std::size_t end     = wrapped ? capacity() : m_head;
+
+    return spans_type(span_type(d + m_tail, d + end),
+                      span_type(d, d + (wrapped ? m_head : 0)));
+  }
+
+  /// write_spans: contiguous ranges of free space, head to wrap point
+  /// and after the wrap point. Use commit_write to publish written elements
+  spans_type write_spans()
+  {
+    iterator    d       = data();
+    bool        wrapped = (m_tail <= m_head) && !full();
+    std::size_t end     = wrapped ? capacity() : m_tail;
+
+    return spans_type(span_type(d + m_head, d + end),
+                      span_type(d, d + (wrapped ? m_tail : 0)));
+  }
+
+  /// commit_write: publish p_count elements written through write_spans
+  void commit_write(std::size_t p_count)
+  {
+    if (p_count != 0)
+    {
+      m_head = cyclic_increment(m_head, p_count, capacity());
+      m_flags.template clear<empty_bit>();
+      if (m_head == m_tail)
+      {
+        m_flags.template set<full_bit>();
+      }
+    }
+  }
+
+  /// commit_read: remove p_count elements read through read_spans
+  void commit_read(std::size_t p_count)
+  {
+    if (p_count != 0)
+    {
+      m_tail = cyclic_increment(m_tail, p_count, capacity());
+      m_flags.template clear<full_bit>();
+      if (m_head == m_tail)
+      {
+        m_flags.template set<empty_bit>();
+      }
+    }
+  }
+
+  iterator data()
+  {
+    return &m_container[0];
   }
 
   container_type      m_container;
   index_type          m_tail;
   index_type          m_head;
   flags_type          m_flags;
+  drop_counter        m_dropped;
+};
+
+/// Power of two capacity specialization.
+/// Head and tail are free running counters, slots are selected by masking
+/// and wrap around of the counters is handled by unsigned arithmetic, so no
+/// flags word is needed and size is a single subtraction. The whole storage
+/// capacity of the container is used.
+
+template< typename  RandomAccessContainerType, 
+          typename  FlagsBaseType,
+          typename  OverflowPolicy>
+struct ring_buffer<RandomAccessContainerType, FlagsBaseType, OverflowPolicy, true>
+{
+  typedef RandomAccessContainerType             container_type;
+  typedef typename container_type::value_type   base_type;
+  typedef base_type*                            iterator;
+  typedef std::size_t                           index_type;
+  typedef fragment<iterator>                    span_type;
+  typedef std::pair<span_type, span_type>       spans_type;
+  typedef OverflowPolicy                        overflow_policy;
+
+  static constexpr index_type c_capacity = 
+    static_capacity<container_type>::value;
+  static constexpr index_type c_mask     = c_capacity - 1;
+
+  ring_buffer()
+  {
+    clear();
+  }
+
+  /// clear the buffer
+  void clear()
+  {
+    m_tail    = 0;
+    m_head    = 0;
+  }
+
+  /// capacity: maximum number of elements
+  constexpr std::size_t capacity() const
+  {
+    return c_capacity;
+  }
+  
+  /// size: how many elements are written/available to read
+  std::size_t size() const
+  {
+    return m_head - m_tail;
+  }
+
+  /// remaining: remaining free space to write
+  std::size_t remaining() const
+  {
+    return capacity() - size();
+  }  
+
+  /// full: returns true if buffer is full
+  bool full() const
+  {
+    return size() == capacity(); 
+  }
+
+  /// full: returns true if buffer is empty
+  bool empty() const
+  {
+    return m_head == m_tail; 
+  }
+  
+  /// push: Add a new element to head. Behaviour on a full buffer is
+  /// defined by the overflow policy. Returns false if element is dropped
+  bool push(const base_type &p_data)
+  {
+    return overflow_policy::push(*this, p_data);
+  }
+
+  /// dropped: number of elements lost due to overflow
+  std::size_t dropped() const
+  {
+    return m_dropped.get();
+  }
+
+  /// pop: remove element from the tail
+  void pop()
+  {
+    m_tail++;
+  }
+  
+  base_type& front() 
+  {
+    return m_container[m_tail & c_mask];
+  }
+
+  base_type& back() 
+  {
+    return m_container[(m_head - 1) & c_mask];
+  }
+
+  /// push_n: Add elements in [first, last) to head. Behaviour on overflow
+  /// is defined by the overflow policy. Returns the number of elements
+  /// accepted
+  template<typename ForwardIterator>
+  std::size_t push_n(ForwardIterator first, ForwardIterator last)
+  {
+    return overflow_policy::push_n(*this, first, last);
+  }
+
+  /// The methods below are used by overflow policies
+
+  void push_unchecked_(const base_type &p_data)
+  {
+    m_container[m_head & c_mask] = p_data;
+    m_head++;
+  }
+
+  void push_overwrite_(const base_type &p_data)
+  {
+    m_container[m_head & c_mask] = p_data;
+    m_head++;
+
+    const std::size_t lost = (m_head - m_tail) > c_capacity;
+
+    m_tail += lost;
+    m_dropped.add(lost);
+  }
+
+  template<typename ForwardIterator>
+  std::size_t push_some_(ForwardIterator first, std::size_t p_count)
+  {
+    std::size_t n     = std::min(p_count, remaining());
+    spans_type  spans = write_spans();
+    std::size_t n0    = std::min(n, spans.first.size());
+
+    std::copy_n(first, n0, spans.first.begin());
+    std::copy_n(std::next(first, n0), n - n0, spans.second.begin());
+    commit_write(n);
+    return n;
+  }
+
+  /// pop_n: Remove up to p_count elements from the tail into out.
+  /// Returns the output iterator past the last element written
+  template<typename OutputIterator>
+  OutputIterator pop_n(OutputIterator out, std::size_t p_count)
+  {
+    std::size_t n     = std::min(p_count, size());
+    spans_type  spans = read_spans();
+    std::size_t n0    = std::min(n, spans.first.size());
+
+    out = std::copy_n(spans.first.begin(), n0, out);
+    out = std::copy_n(spans.second.begin(), n - n0, out);
+    commit_read(n);
+    return out;
+  }
+
+  /// pop_n: Remove all elements into out
+  template<typename OutputIterator>
+  OutputIterator pop_n(OutputIterator out)
+  {
+    return pop_n(out, size());
+  }
+
+  /// read_spans: contiguous ranges of written elements, tail to wrap point
+  /// and after the wrap point. Use commit_read to remove consumed elements
+  spans_type read_spans()
+  {
+    iterator    d     = data();
+    index_type  first = m_tail & c_mask;
+    std::size_t n     = size();
+    std::size_t n0    = std::min(n, capacity() - first);
+
+    return spans_type(span_type(d + first, d + first + n0),
+                      span_type(d, d + (n - n0)));
+  }
+
+  /// write_spans: contiguous ranges of free space, head to wrap point
+  /// and after the wrap point. Use commit_write to publish written elements
+  spans_type write_spans()
+  {
+    iterator    d     = data();
+    index_type  first = m_head & c_mask;
+    std::size_t n     = remaining();
+    std::size_t n0    = std::min(n, capacity() - first);
+
+    return spans_type(span_type(d + first, d + first + n0),
+                      span_type(d, d + (n - n0)));
+  }
+
+  /// commit_write: publish p_count elements written through write_spans
+  void commit_write(std::size_t p_count)
+  {
+    m_head += p_count;
+  }
+
+  /// commit_read: remove p_count elements read through read_spans
+  void commit_read(std::size_t p_count)
+  {
+    m_tail += p_count;
+  }
+
+  iterator data()
+  {
+    return &m_container[0];
+  }
+
+  container_type      m_container;
+  index_type          m_tail;
+  index_type          m_head;
+  drop_counter        m_dropped;
 };
 
 } // namespace haluj
@@ -33,6 +33,11 @@ For more information, please refer to <http://unlicense.org>
 #ifndef HALUJ_STATE_MACHINE_HPP
 #define HALUJ_STATE_MACHINE_HPP
 
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 
 namespace haluj
@@ -49,7 +54,7 @@ struct g_always_t
 };
 
 template < typename... Args >
-inline void _invoke_a(std::nullptr_t np, Args&&...  args)
+inline void _invoke_a(std::nullptr_t, Args&&...)
 {}
 
 template < typename Action, typename... Args >
@@ -60,6 +65,132 @@ inline void _invoke_a(Action&& action, Args&&... args)
 
 constexpr g_always_t g_always;
 
+/// State Child is nested in state Parent
+template <auto Child, decltype(Child) Parent>
+struct parent_t
+{
+  typedef decltype(Child)   state_type;
+
+  static constexpr bool       is_parent   = true;
+  static constexpr state_type first       = Child;
+  static constexpr state_type second      = Parent;
+};
+
+template <auto Child, decltype(Child) Parent>
+constexpr parent_t<Child, Parent>
+parent()
+{
+  return parent_t<Child, Parent>();
+}
+
+/// Entering composite state State continues with its substate Initial
+template <auto State, decltype(State) Initial>
+struct initial_t
+{
+  typedef decltype(State)   state_type;
+
+  static constexpr bool       is_parent   = false;
+  static constexpr state_type first       = State;
+  static constexpr state_type second      = Initial;
+};
+
+template <auto State, decltype(State) Initial>
+constexpr initial_t<State, Initial>
+initial()
+{
+  return initial_t<State, Initial>();
+}
+
+/// State hierarchy built from parent_t and initial_t relations.
+/// Transitions declared on a parent state are inherited by its substates, 
+/// substate transitions take precedence. All queries are resolved at 
+/// compile time.
+template <typename... Relations>
+struct hierarchy_t
+{
+  static constexpr bool c_empty = (sizeof...(Relations) == 0);
+
+  static constexpr long long c_min =
+    std::min({std::numeric_limits<long long>::max(),
+              static_cast<long long>(Relations::first)...,
+              static_cast<long long>(Relations::second)...});
+
+  static constexpr long long c_max =
+    std::max({std::numeric_limits<long long>::min(),
+              static_cast<long long>(Relations::first)...,
+              static_cast<long long>(Relations::second)...});
+
+  template <typename StateType>
+  static constexpr bool has_parent([[maybe_unused]] const StateType p_state)
+  {
+    return (false || ... || (Relations::is_parent && 
+                             Relations::first == p_state));
+  }
+
+  template <typename StateType>
+  static constexpr StateType parent_of([[maybe_unused]] const StateType p_state)
+  {
+    StateType result = p_state;
+    ((Relations::is_parent && Relations::first == p_state ? 
+      (result = Relations::second, 0) : 0), ...);
+    return result;
+  }
+
+  template <typename StateType>
+  static constexpr bool has_initial([[maybe_unused]] const StateType p_state)
+  {
+    return (false || ... || (!Relations::is_parent && 
+                             Relations::first == p_state));
+  }
+
+  template <typename StateType>
+  static constexpr StateType initial_of([[maybe_unused]] const StateType p_state)
+  {
+    StateType result = p_state;
+    ((!Relations::is_parent && Relations::first == p_state ? 
+      (result = Relations::second, 0) : 0), ...);
+    return result;
+  }
+
+  /// true if p_state is p_ancestor or nested in it
+  template <typename StateType>
+  static constexpr bool contains(const StateType p_ancestor, 
+                                 StateType       p_state)
+  {
+    while (p_state != p_ancestor && has_parent(p_state))
+    {
+      p_state = parent_of(p_state);
+    }
+    return p_state == p_ancestor;
+  }
+
+  /// innermost state which is neither exited nor entered by a transition
+  /// from p_from to p_to. first is false if the transition leaves the 
+  /// outermost state (e.g. in flat machines)
+  template <typename StateType>
+  static constexpr std::pair<bool, StateType> 
+  boundary(const StateType p_from, const StateType p_to)
+  {
+    bool      found = false;
+    StateType s     = p_from;
+
+    while (!found && has_parent(s))
+    {
+      s     = parent_of(s);
+      found = contains(s, p_to);
+    }
+
+    return std::pair<bool, StateType>(found, s);
+  }
+};
+
+template <typename... Relations>
+constexpr hierarchy_t<Relations...>
+hierarchy(Relations...)
+{
+  return hierarchy_t<Relations...>();
+}
+
 /// generic transition template
 template 
 < 
@@ -95,13 +226,89 @@ struct transition_t
   state_type do_transition(const StateActionMap&  p_map, 
                            Args&&...              args) const
   {
-    p_map.exit_(from, std::forward<Args>(args)...);
+    return 
+      do_transition<hierarchy_t<>, from>(p_map, std::forward<Args>(args)...);
+  }
+
+  /// exits states from Leaf up to the boundary state, calls the action, 
+  /// enters states down to the target and then its initial substates. 
+  /// Returns the innermost entered state
+  template<typename       Hierarchy,
+           state_type     Leaf,
+           typename       StateActionMap, 
+           typename...    Args>
+  state_type do_transition(const StateActionMap&  p_map, 
+                           Args&&...              args) const
+  {
+    constexpr auto bound = Hierarchy::boundary(from, to);
+
+    exit_chain_<Hierarchy, Leaf, bound.first, bound.second>(p_map, args...);
 
     _invoke_a(action, std::forward<Args>(args)...);
 
-    p_map.enter_(to, std::forward<Args>(args)...);
+    enter_chain_<Hierarchy, to, bound.first, bound.second>(p_map, args...);
     
-    return to;
+    return enter_initial_<Hierarchy, to>(p_map, args...);
+  }
+
+  template<typename       Hierarchy,
+           state_type     State,
+           bool           BoundValid,
+           state_type     Bound,
+           typename       StateActionMap, 
+           typename...    Args>
+  static void exit_chain_(const StateActionMap& p_map, Args&&... args)
+  {
+    if constexpr (!(BoundValid && State == Bound))
+    {
+      p_map.template exit_<State>(args...);
+
+      if constexpr (Hierarchy::has_parent(State))
+      {
+        exit_chain_<Hierarchy, Hierarchy::parent_of(State), BoundValid, Bound>
+          (p_map, args...);
+      }
+    }
+  }
+
+  template<typename       Hierarchy,
+           state_type     State,
+           bool           BoundValid,
+           state_type     Bound,
+           typename       StateActionMap, 
+           typename...    Args>
+  static void enter_chain_(const StateActionMap& p_map, Args&&... args)
+  {
+    if constexpr (!(BoundValid && State == Bound))
+    {
+      if constexpr (Hierarchy::has_parent(State))
+      {
+        enter_chain_<Hierarchy, Hierarchy::parent_of(State), BoundValid, Bound>
+          (p_map, args...);
+      }
+
+      p_map.template enter_<State>(args...);
+    }
+  }
+
+  template<typename       Hierarchy,
+           state_type     State,
+           typename       StateActionMap, 
+           typename...    Args>
+  static state_type enter_initial_(const StateActionMap& p_map, Args&&... args)
+  {
+    if constexpr (Hierarchy::has_initial(State))
+    {
+      constexpr state_type initial = Hierarchy::initial_of(State);
+
+      p_map.template enter_<initial>(args...);
+
+      return enter_initial_<Hierarchy, initial>(p_map, args...);
+    }
+    else
+    {
+      return State;
+    }
   }
 
   const trigger_type  trigger;
@@ -124,6 +331,9 @@ transition(TriggerType  trigger,
       (trigger, action);
 }
 
+/// Largest state value range for which graph_t builds a dispatch table
+constexpr long long c_max_dispatch_table_size = 256;
+
 /// generic empty graph template for variadic template final nesting
 template <typename... Entries>
 struct graph_t
@@ -138,32 +348,366 @@ struct graph_t
   {
     return p_current;
   }
+
+  template <typename Hierarchy = hierarchy_t<>,
+            typename StateType, 
+            typename StateActionMap,
+            typename... Args>
+  StateType step(const StateType          p_current, 
+                 const StateActionMap&    p_map,
+                 Args&&...                args) const
+  {
+    p_map.do_(p_current, std::forward<Args>(args)...);
+    return p_current;
+  }
+
+  template <typename StateType, 
+            typename StateActionMap,
+            typename... Args>
+  StateType linear_(const StateType          p_current, 
+                    const StateActionMap&,
+                    Args&&...) const
+  {
+    return p_current;
+  }
+
+  template <auto                State,
+            typename            Hierarchy,
+            decltype(State)     Leaf,
+            typename            StateActionMap,
+            typename...         Args>
+  bool step_from_(decltype(State)&,
+                  const StateActionMap&,
+                  Args&&...) const
+  {
+    return false;
+  }
 };
 
 /// generic empty graph template for variadic template packing
+/// When states are enumerations or integers spanning a small range, a 
+/// table of per-state functions is built at compile time, so that a step 
+/// only tests the transitions leaving the current state. Otherwise 
+/// transitions are tested linearly in declaration order.
 template <typename EdgeType, typename... Entries>
 struct graph_t<EdgeType, Entries...>
 {
-  typedef   graph_t<Entries...>    next;
-  typedef   EdgeType               edge_type;
+  typedef   graph_t<Entries...>                 next;
+  typedef   EdgeType                            edge_type;
+  typedef   typename edge_type::state_type      state_type;
+
+  static constexpr bool c_indexable = 
+    std::is_enum<state_type>::value || std::is_integral<state_type>::value;
+
+  static constexpr long long c_from_min =
+    std::min({static_cast<long long>(EdgeType::from),
+              static_cast<long long>(Entries::from)...});
+
+  static constexpr long long c_from_max =
+    std::max({static_cast<long long>(EdgeType::from),
+              static_cast<long long>(Entries::from)...});
+
+  /// states of the hierarchy may have no transitions of their own, so the 
+  /// table covers them as well
+  template <typename Hierarchy>
+  struct range_
+  {
+    static constexpr long long c_min = 
+      Hierarchy::c_empty ? c_from_min : std::min(c_from_min, Hierarchy::c_min);
+
+    static constexpr long long c_max = 
+      Hierarchy::c_empty ? c_from_max : std::max(c_from_max, Hierarchy::c_max);
+
+    static constexpr bool c_use_table = 
+      c_indexable && ((c_max - c_min) < c_max_dispatch_table_size);
+  };
 
   graph_t(const EdgeType& p_edge, Entries... args)
   : edge_(p_edge), next_(args...)
   {}
 
+  /// evaluates transitions of the current state
   template <typename StateType, 
             typename StateActionMap,
             typename... Args>
   StateType operator()(const StateType          p_current, 
                        const StateActionMap&    p_map,
                        Args&&...                args) const
+  {
+    if constexpr (range_<hierarchy_t<>>::c_use_table)
+    {
+      return 
+        dispatch_<false, hierarchy_t<>>(p_current, 
+                                        p_map, 
+                                        std::forward<Args>(args)...);
+    }
+    else
+    {
+      return linear_(p_current, p_map, std::forward<Args>(args)...);
+    }
+  }
+
+  /// calls do_ action of the current state, then evaluates its transitions
+  /// and the transitions inherited from its parent states
+  template <typename Hierarchy = hierarchy_t<>,
+            typename StateType, 
+            typename StateActionMap,
+            typename... Args>
+  StateType step(const StateType          p_current, 
+                 const StateActionMap&    p_map,
+                 Args&&...                args) const
+  {
+    if constexpr (range_<Hierarchy>::c_use_table)
+    {
+      return 
+        dispatch_<true, Hierarchy>(p_current, 
+                                   p_map, 
+                                   std::forward<Args>(args)...);
+    }
+    else
+    {
+      static_assert(Hierarchy::c_empty, 
+                    "hierarchical states require a dispatch table");
+
+      p_map.do_(p_current, args...);
+      return linear_(p_current, p_map, std::forward<Args>(args)...);
+    }
+  }
+
+  template <typename StateType, 
+            typename StateActionMap,
+            typename... Args>
+  StateType linear_(const StateType          p_current, 
+                    const StateActionMap&    p_map,
+                    Args&&...                args) const
   {
     if (edge_.test(p_current, std::forward<Args>(args)...))
     {
       return edge_.do_transition(p_map, std::forward<Args>(args)...);
     }
 
-    return next_(p_current, p_map, std::forward<Args>(args)...);
+    return next_.linear_(p_current, p_map, std::forward<Args>(args)...);
+  }
+
+  /// evaluates only the transitions leaving State, in declaration order.
+  /// Leaf is the active state, which is State or one of its substates
+  template <auto                State,
+            typename            Hierarchy,
+            decltype(State)     Leaf,
+            typename            StateActionMap,
+            typename...         Args>
+  bool step_from_(decltype(State)&          p_result,
+                  const StateActionMap&     p_map,
+                  Args&&...                 args) const
+  {
+    if constexpr (edge_type::from == State)
+    {
+      if (edge_.trigger(args...))
+      {
+        p_result = 
+          edge_.template do_transition<Hierarchy, Leaf>
+            (p_map, std::forward<Args>(args)...);
+        return true;
+      }
+    }
+
+    return 
+      next_.template step_from_<State, Hierarchy, Leaf>
+        (p_result, p_map, std::forward<Args>(args)...);
+  }
+
+  /// evaluates transitions of State, then of its parents, innermost first
+  template <auto                State,
+            typename            Hierarchy,
+            decltype(State)     Leaf,
+            typename            StateActionMap,
+            typename...         Args>
+  bool step_up_(decltype(State)&          p_result,
+                const StateActionMap&     p_map,
+                Args&&...                 args) const
+  {
+    if (step_from_<State, Hierarchy, Leaf>(p_result, p_map, args...))
+    {
+      return true;
+    }
+
+    if constexpr (Hierarchy::has_parent(State))
+    {
+      return 
+        step_up_<Hierarchy::parent_of(State), Hierarchy, Leaf>
+          (p_result, p_map, std::forward<Args>(args)...);
+    }
+    else
+    {
+      return false;
+    }
+  }
+
+  /// do_ actions of the active states, outermost first
+  template <auto                State,
+            typename            Hierarchy,
+            typename            StateActionMap,
+            typename...         Args>
+  static void do_chain_(const StateActionMap&     p_map,
+                        Args&&...                 args)
+  {
+    if constexpr (Hierarchy::has_parent(State))
+    {
+      do_chain_<Hierarchy::parent_of(State), Hierarchy>(p_map, args...);
+    }
+    p_map.template do_<State>(args...);
+  }
+
+  template <auto      State,
+            bool      Do,
+            typename  Hierarchy,
+            typename  StateActionMap,
+            typename... Args>
+  static state_type state_step_(const graph_t&         p_graph,
+                                const StateActionMap&  p_map,
+                                Args&&...              args)
+  {
+    state_type result = State;
+
+    if constexpr (Do)
+    {
+      do_chain_<State, Hierarchy>(p_map, args...);
+    }
+
+    p_graph.template step_up_<State, Hierarchy, State>
+      (result, p_map, std::forward<Args>(args)...);
+    return result;
+  }
+
+  template <bool      Do,
+            typename  Hierarchy,
+            typename  StateActionMap,
+            typename... Args>
+  struct dispatch_table_
+  {
+    typedef state_type (*function_type)(const graph_t&, 
+                                        const StateActionMap&, 
+                                        Args&&...);
+
+    static constexpr long long c_min = range_<Hierarchy>::c_min;
+
+    static constexpr std::size_t c_size = 
+      static_cast<std::size_t>(range_<Hierarchy>::c_max - c_min + 1);
+
+    template <std::size_t... I>
+    static constexpr std::array<function_type, c_size>
+    make(std::index_sequence<I...>)
+    {
+      return 
+      {{
+        &graph_t::template state_step_
+        <
+          static_cast<state_type>(c_min + static_cast<long long>(I)),
+          Do,
+          Hierarchy,
+          StateActionMap,
+          Args...
+        >...
+      }};
+    }
+
+    static constexpr std::array<function_type, c_size> value = 
+      make(std::make_index_sequence<c_size>());
+  };
+
+  template <bool      Do,
+            typename  Hierarchy,
+            typename  StateActionMap,
+            typename... Args>
+  state_type dispatch_(const state_type         p_current, 
+                       const StateActionMap&    p_map,
+                       Args&&...                args) const
+  {
+    typedef dispatch_table_<Do, Hierarchy, StateActionMap, Args...> table;
+
+    const long long index = static_cast<long long>(p_current) - table::c_min;
+
+    if (index < 0 || index >= static_cast<long long>(table::c_size))
+    {
+      // state without outgoing transitions
+      if constexpr (Do)
+      {
+        p_map.do_(p_current, args...);
+      }
+      return p_current;
+    }
+
+    return table::value[index](*this, p_map, std::forward<Args>(args)...);
+  }
+
+  /// steps p_count instances. Instance i is in state p_states[i] and 
+  /// receives p_events[i]. Instances are grouped by state first (counting
+  /// sort into p_order, which must hold p_count indices), so that each 
+  /// group is stepped in a tight loop through the same state function.
+  template <typename  Hierarchy,
+            typename  StateActionMap,
+            typename  EventType>
+  void step_n(state_type*             p_states,
+              const EventType*        p_events,
+              const std::size_t       p_count,
+              std::size_t*            p_order,
+              const StateActionMap&   p_map) const
+  {
+    static_assert(range_<Hierarchy>::c_use_table, 
+                  "batch stepping requires a dispatch table");
+
+    typedef 
+      dispatch_table_<true, Hierarchy, StateActionMap, const EventType&> 
+      table;
+
+    // the last group collects states without a table entry
+    constexpr std::size_t c_groups = table::c_size + 1;
+
+    std::size_t position[c_groups + 1] = {};
+
+    auto group_of = [](const state_type p_state)
+    {
+      const long long index = static_cast<long long>(p_state) - table::c_min;
+
+      return (index < 0 || index >= static_cast<long long>(table::c_size)) ? 
+        table::c_size : static_cast<std::size_t>(index);
+    };
+
+    for (std::size_t i = 0; i < p_count; i++)
+    {
+      position[group_of(p_states[i]) + 1]++;
+    }
+
+    for (std::size_t g = 1; g < c_groups; g++)
+    {
+      position[g] += position[g - 1];
+    }
+
+    for (std::size_t i = 0; i < p_count; i++)
+    {
+      p_order[position[group_of(p_states[i])]++] = i;
+    }
+
+    // position[g] is now the end of group g
+    std::size_t first = 0;
+
+    for (std::size_t g = 0; g < table::c_size; g++)
+    {
+      const auto function = table::value[g];
+      const auto last     = position[g];
+
+      for (; first < last; first++)
+      {
+        const std::size_t i = p_order[first];
+        p_states[i] = function(*this, p_map, p_events[i]);
+      }
+    }
+
+    for (; first < p_count; first++)
+    {
+      const std::size_t i = p_order[first];
+      p_map.do_(p_states[i], p_events[i]);
+    }
   }
 
   const edge_type     edge_;
@@ -224,6 +768,18 @@ struct map_t
   void exit_(const KeyType&, Args...) const
   {}
 
+  template <auto Key, typename... Args>  
+  void enter_(Args&&...) const
+  {}
+
+  template <auto Key, typename... Args>  
+  void do_(Args&&...) const
+  {}
+
+  template <auto Key, typename... Args>  
+  void exit_(Args&&...) const
+  {}
+
 };
 
 /// generic map template for variadic template packing
@@ -278,6 +834,46 @@ struct map_t<EntryType, Entries...>
       next_.exit_(p_key, std::forward<Args>(args)...);
     }
   }
+
+  // compile time key versions, resolved without runtime key comparison
+  template <auto Key, typename... Args>  
+  void enter_(Args&&... args) const
+  {
+    if constexpr (entry_type::key == Key)
+    {
+      _invoke_a(std::get<0>(pair_.value), std::forward<Args>(args)...);
+    }
+    else
+    {
+      next_.template enter_<Key>(std::forward<Args>(args)...);
+    }
+  }
+
+  template <auto Key, typename... Args>  
+  void do_(Args&&... args) const
+  {
+    if constexpr (entry_type::key == Key)
+    {
+      _invoke_a(std::get<1>(pair_.value), std::forward<Args>(args)...);
+    }
+    else
+    {
+      next_.template do_<Key>(std::forward<Args>(args)...);
+    }
+  }
+
+  template <auto Key, typename... Args>  
+  void exit_(Args&&... args) const
+  {
+    if constexpr (entry_type::key == Key)
+    {
+      _invoke_a(std::get<2>(pair_.value), std::forward<Args>(args)...);
+    }
+    else
+    {
+      next_.template exit_<Key>(std::forward<Args>(args)...);
+    }
+  }
   
   const entry_type  pair_;
   const next        next_;
@@ -298,12 +894,16 @@ map(const EntryType& p_a, Entries... args)
 }
 
 /// core state machine
+/// Hierarchy describes nested states, see hierarchy_t. Flat machines use
+/// the empty hierarchy
 template <typename GraphType,
-          typename MapType>
+          typename MapType,
+          typename HierarchyType = hierarchy_t<>>
 struct machine_t
 {
-  typedef     GraphType     graph_type;
-  typedef     MapType       map_type;
+  typedef     GraphType       graph_type;
+  typedef     MapType         map_type;
+  typedef     HierarchyType   hierarchy_type;
   
   machine_t(const GraphType&  p_graph, 
             const MapType&    p_map)
@@ -314,8 +914,24 @@ struct machine_t
   template<typename StateType, typename... Args>
   StateType operator()(const StateType p_current, Args&&... args) const
   {
-    map_.do_(p_current, args...);
-    return graph_(p_current, map_, std::forward<Args>(args)...);
+    return 
+      graph_.template step<hierarchy_type>(p_current, 
+                                           map_, 
+                                           std::forward<Args>(args)...);
+  }
+  
+  /// steps p_count machines at once, see graph_t::step_n
+  template<typename StateType, typename EventType>
+  void step_n(StateType*          p_states,
+              const EventType*    p_events,
+              const std::size_t   p_count,
+              std::size_t*        p_order) const
+  {
+    graph_.template step_n<hierarchy_type>(p_states, 
+                                           p_events, 
+                                           p_count, 
+                                           p_order, 
+                                           map_);
   }
   
   const graph_type        graph_;
@@ -334,6 +950,19 @@ machine(const GraphType   &p_graph,
     
 }
 
+template <typename GraphType,
+          typename MapType,
+          typename HierarchyType>
+machine_t<GraphType, MapType, HierarchyType>
+machine(const GraphType       &p_graph, 
+        const MapType         &p_map,
+        const HierarchyType   &)
+{
+  return 
+    machine_t<GraphType, MapType, HierarchyType>
+      (p_graph, p_map);
+}
+
 } // namespace haluj
 
 #endif //  HALUJ_STATE_MACHINE_HPP
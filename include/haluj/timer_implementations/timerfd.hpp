@@ -0,0 +1,200 @@
+/// \file timerfd.hpp
+/// Linux timerfd based timer implementation
+/*
+This is free and unencumbered software released into the public domain.
+
+Anyone is free to copy, modify, publish, use, compile, sell, or
+distribute this software, either in source code form or as a compiled
+binary, for any purpose, commercial or non-commercial, and by any
+means.
+
+In jurisdictions that recognize copyright laws, the author or authors
+of this software dedicate any and all copyright interest in the
+software to the public domain. We make this dedication for the benefit
+of the public at large and to the detriment of our heirs and
+successors. We intend this dedication to be an overt act of
+relinquishment in perpetuity of all present and future rights to this
+software under copyright law.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+
+For more information, please refer to <http://unlicense.org>
+*/
+/// \author Selcuk Iyikalender
+/// \date   2026
+
+/*! Basic usage:
+* \code {.cpp}
+* namespace ti = haluj::timer_implementations;
+* haluj::timer<ti::timerfd<std::chrono::milliseconds, true>> t;
+* t.set(std::chrono::milliseconds(20));
+* // t.impl_.fd() becomes readable when the timer expires, wait on it with
+* // poll/epoll (see epoll_reactor.hpp) then call t(function) as usual
+* \endcode
+* The kernel keeps the time, so the process can sleep until expiration.
+* With AutoReset the timer is armed periodically, expirations missed 
+* between two calls are reported once. A value loaded while running is
+* applied at the next expiration.
+*/
+
+#ifndef HALUJ_TIMER_IMPLEMENTATIONS_TIMERFD_HPP
+#define HALUJ_TIMER_IMPLEMENTATIONS_TIMERFD_HPP
+
+#if defined(__linux__)
+
+#include <cstdint>
+#include <chrono>
+#include <ctime>
+
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace haluj
+{
+
+namespace timer_implementations
+{
+
+template
+<
+  typename  Duration  = std::chrono::nanoseconds,
+  bool      AutoReset = true,
+  int       ClockId   = CLOCK_MONOTONIC
+>
+struct timerfd
+{
+  typedef Duration  duration;
+
+  static constexpr bool auto_reset = AutoReset;
+
+  timerfd()
+  : fd_(::timerfd_create(ClockId, TFD_NONBLOCK | TFD_CLOEXEC))
+  {}
+
+  timerfd(const timerfd& ) = delete;
+
+  timerfd(timerfd&& ) = delete;
+
+  ~timerfd()
+  {
+    if (is_open())
+    {
+      ::close(fd_);
+    }
+  }
+
+  /// is_open: false if the timer file descriptor could not be created
+  bool is_open() const
+  {
+    return fd_ >= 0;
+  }
+
+  /// fd: file descriptor, readable while an expiration is pending
+  int fd() const
+  {
+    return fd_;
+  }
+
+  void load(duration p_value) 
+  {
+    load_ = p_value;
+  }
+
+  void start()
+  {
+    run_ = true;
+  }
+
+  void stop()
+  {
+    run_      = false;
+    expired_  = false;
+    arm_(duration(0), false);
+  }
+
+  bool is_running() const
+  {
+    return run_;
+  }
+
+  void iterate(duration p_delta)
+  {}
+
+  /// predicate: true if the timer expired since the last reset or call
+  bool predicate() const
+  {
+    std::uint64_t count = 0;
+    if (::read(fd_, &count, sizeof(count)) == sizeof(count) && count != 0)
+    {
+      expired_ = true;
+    }
+    return expired_;
+  }
+
+  void reset()
+  {
+    expired_ = false;
+    arm_(load_, true);
+  }
+
+  bool operator ()(duration)
+  {
+    bool result = run_ && predicate();
+
+    if (auto_reset && result)
+    {
+      expired_ = false;
+      if (armed_ != load_)
+      {
+        arm_(load_, true);
+      }
+    }
+
+    return result;
+  }
+
+// private:
+
+  /// arm_: expire after p_value, then every p_value if auto_reset
+  void arm_(const duration p_value, const bool p_enable)
+  {
+    typedef std::chrono::nanoseconds ns;
+
+    ns value = std::chrono::duration_cast<ns>(p_value);
+    if (p_enable && value <= ns(0))
+    {
+      // zero disarms a timerfd
+      value = ns(1);
+    }
+
+    itimerspec spec = {};
+    spec.it_value.tv_sec  = std::time_t(value.count() / 1000000000);
+    spec.it_value.tv_nsec = long(value.count() % 1000000000);
+    if (auto_reset)
+    {
+      spec.it_interval = spec.it_value;
+    }
+    ::timerfd_settime(fd_, 0, &spec, nullptr);
+    armed_ = p_value;
+  }
+
+  int           fd_;
+  bool          run_      = false;
+  mutable bool  expired_  = false;
+  duration      load_     = duration(0);
+  duration      armed_    = duration(0);
+};
+
+} // namespace timer_implementations
+
+} // namespace haluj
+
+#endif // __linux__
+
+#endif // HALUJ_TIMER_IMPLEMENTATIONS_TIMERFD_HPP
@@ -0,0 +1,326 @@
+/// \file timer_wheel.hpp
+/// Hierarchical timing wheel driving many timers from a single tick
+/*
+This is free and unencumbered software released into the public domain.
+
+Anyone is free to copy, modify, publish, use, compile, sell, or
+distribute this software, either in source code form or as a compiled
+binary, for any purpose, commercial or non-commercial, and by any
+means.
+
+In jurisdictions that recognize copyright laws, the author or authors
+of this software dedicate any and all copyright interest in the
+software to the public domain. We make this dedication for the benefit
+of the public at large and to the detriment of our heirs and
+successors. We intend this dedication to be an overt act of
+relinquishment in perpetuity of all present and future rights to this
+software under copyright law.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+
+For more information, please refer to <http://unlicense.org>
+*/
+/// \author Selcuk Iyikalender
+/// \date   2026
+
+/*! Basic usage:
+* \code {.cpp}
+* struct connection { haluj::timer_wheel<haluj::one_shot>::timer timeout; ... };
+*
+* haluj::timer_wheel<haluj::one_shot> wheel;
+* wheel.set(c.timeout, 3000);   // expires 3000 ticks later
+* ...
+* // called once per tick, e.g. every millisecond
+* wheel([](auto& t) { close(owner_of(t)); });
+* \endcode
+* The wheel counts time in ticks. set/load/stop behave as haluj::timer
+* with a software::bwd implementation polled once per tick: a timer set to
+* v expires after v ticks (at least 1), a loaded value is used from the
+* next period on, the behaviour decides after each expiration whether the
+* timer keeps running.
+* Level l of the wheel has 2^SlotBits slots of 2^(l * SlotBits) ticks, a
+* timer is kept in the lowest level covering its remaining time and moves
+* down (cascades) when its slot is reached. Start and stop are O(1) list
+* operations, a tick visits one level 0 slot and cascades a higher level
+* slot only every 2^SlotBits ticks. Timers further than the wheel range
+* are parked in the top level and cascade again until they are in range.
+*/
+
+#ifndef HALUJ_TIMER_WHEEL_HPP
+#define HALUJ_TIMER_WHEEL_HPP
+
+#include <cstdint>
+#include <array>
+#include <type_traits>
+
+#include "timer.hpp"
+
+namespace haluj
+{
+
+template
+<
+  typename    Behaviour = periodic,
+  std::size_t Levels    = 4,
+  std::size_t SlotBits  = 6
+>
+struct timer_wheel
+{
+  static_assert(Levels > 0 && SlotBits > 0 && Levels * SlotBits < 64, 
+                "timer_wheel range must fit in 64 bits");
+
+  // Types
+
+  typedef Behaviour     behaviour;
+  typedef std::uint64_t tick_type;
+  typedef tick_type     duration;
+
+  static constexpr std::size_t  c_slots = std::size_t(1) << SlotBits;
+  static constexpr tick_type    c_mask  = c_slots - 1;
+  static constexpr tick_type    c_range = tick_type(1) << (Levels * SlotBits);
+
+  /// Timer entry, linked into the wheel while running. Embed it into the
+  /// object it times; it must not move while running
+
+  struct timer
+  {
+    timer()
+    {}
+
+    timer(const timer& ) = delete;
+
+    timer(timer&& ) = delete;
+
+    ~timer()
+    {
+      unlink_();
+    }
+
+    bool is_running() const
+    {
+      return run_;
+    }
+
+    /// expires: tick of the next expiration
+    tick_type expires() const
+    {
+      return expires_;
+    }
+
+    bool is_linked_() const
+    {
+      return pprev_ != nullptr;
+    }
+
+    void unlink_()
+    {
+      if (is_linked_())
+      {
+        *pprev_ = next_;
+        if (next_ != nullptr) next_->pprev_ = pprev_;
+        next_   = nullptr;
+        pprev_  = nullptr;
+      }
+    }
+
+    timer*      next_     = nullptr;
+    timer**     pprev_    = nullptr;
+    tick_type   expires_  = 0;
+    duration    load_     = 0;
+    bool        run_      = false;
+  };
+
+  // Constructors
+
+  timer_wheel()
+  {}
+
+  timer_wheel(const timer_wheel& ) = delete;
+
+  timer_wheel(timer_wheel&& ) = delete;
+
+  ~timer_wheel()
+  {
+    for (auto &level : wheel_)
+    {
+      for (auto &head : level)
+      {
+        while (head != nullptr) stop(*head);
+      }
+    }
+  }
+
+  // Operators
+
+  /// advance p_delta ticks, calling p_function(timer&) through the 
+  /// behaviour for each expiring timer. Returns the number of expirations
+  template
+  <
+    typename Function     = std::nullptr_t,
+    typename DurationType = int
+  >
+  std::size_t operator()
+  (
+    Function      p_function  = Function(),
+    DurationType  p_delta     = DurationType(1)
+  )
+  {
+    std::size_t result = 0;
+    for (tick_type n = tick_type(p_delta); n != 0; n--)
+    {
+      result += tick_(p_function);
+    }
+    return result;
+  }
+
+  // Methods
+
+  /// set: load p_value and start p_timer, it expires after p_value ticks
+  void set(timer& p_timer, duration p_value)
+  {
+    p_timer.unlink_();
+    p_timer.load_     = p_value;
+    p_timer.run_      = true;
+    p_timer.expires_  = now_ + period_(p_value);
+    insert_(p_timer);
+  }
+
+  /// load: period used from the next expiration on
+  void load(timer& p_timer, duration p_value)
+  {
+    p_timer.load_ = p_value;
+  }
+
+  void stop(timer& p_timer)
+  {
+    p_timer.unlink_();
+    p_timer.run_ = false;
+  }
+
+  /// now: ticks elapsed since construction
+  tick_type now() const
+  {
+    return now_;
+  }
+
+// private:
+
+  static duration period_(const duration p_value)
+  {
+    return (p_value != 0) ? p_value : 1;
+  }
+
+  static void push_(timer*& p_head, timer& p_timer)
+  {
+    p_timer.next_   = p_head;
+    p_timer.pprev_  = &p_head;
+    if (p_head != nullptr) p_head->pprev_ = &p_timer.next_;
+    p_head = &p_timer;
+  }
+
+  /// splice_: move list p_from to p_to, keeping the back links valid
+  static void splice_(timer*& p_from, timer*& p_to)
+  {
+    p_to    = p_from;
+    p_from  = nullptr;
+    if (p_to != nullptr) p_to->pprev_ = &p_to;
+  }
+
+  void insert_(timer& p_timer)
+  {
+    tick_type delta   = p_timer.expires_ - now_;
+    tick_type expires = p_timer.expires_;
+    if (delta >= c_range)
+    {
+      delta   = c_range - 1;
+      expires = now_ + delta;
+    }
+
+    std::size_t level = 0;
+    while ((level + 1 < Levels) && (delta >> ((level + 1) * SlotBits)) != 0)
+    {
+      level++;
+    }
+    push_(wheel_[level][(expires >> (level * SlotBits)) & c_mask], p_timer);
+  }
+
+  /// cascade_: reinsert the timers of the current slot of p_level
+  void cascade_(const std::size_t p_level)
+  {
+    timer* pending;
+    splice_(wheel_[p_level][(now_ >> (p_level * SlotBits)) & c_mask], pending);
+    while (pending != nullptr)
+    {
+      timer& t = *pending;
+      t.unlink_();
+      insert_(t);
+    }
+  }
+
+  template<typename Function>
+  std::size_t tick_(Function& p_function)
+  {
+    std::size_t result = 0;
+
+    now_++;
+
+    for (std::size_t level = 1; 
+         (level < Levels) && ((now_ >> ((level - 1) * SlotBits)) & c_mask) == 0; 
+         level++)
+    {
+      cascade_(level);
+    }
+
+    timer* pending;
+    splice_(wheel_[0][now_ & c_mask], pending);
+    while (pending != nullptr)
+    {
+      timer& t = *pending;
+      t.unlink_();
+      result++;
+      const bool done = fire_(t, p_function);
+      if (t.is_linked_())
+      {
+        // set again by the function
+      }
+      else if (done)
+      {
+        t.run_ = false;
+      }
+      else if (t.run_)
+      {
+        t.expires_ += period_(t.load_);
+        insert_(t);
+      }
+    }
+
+    return result;
+  }
+
+  template<typename Function>
+  bool fire_(timer& p_timer, Function& p_function)
+  {
+    if constexpr (std::is_same<Function, std::nullptr_t>::value)
+    {
+      return behaviour_(nullptr);
+    }
+    else
+    {
+      return behaviour_([&]() { return p_function(p_timer); });
+    }
+  }
+
+  std::array<std::array<timer*, c_slots>, Levels>  wheel_    = {};
+  tick_type                                         now_      = 0;
+  behaviour                                         behaviour_;
+};
+
+} // namespace haluj
+
+#endif // HALUJ_TIMER_WHEEL_HPP
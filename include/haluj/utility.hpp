@@ -6,6 +6,10 @@
 namespace haluj
 {
 
+/// Assumed destructive interference size. Members written by different
+/// threads are aligned to this value to avoid false sharing.
+constexpr std::size_t cache_line_size = 64;
+
 template<typename T, std::size_t N>
 constexpr std::size_t array_size(const T (&arr)[N])
 {
@@ -0,0 +1,62 @@
+/// \file mapped_ring_buffer.cpp
+/// mapped_ring_buffer test:
+/// g++ -std=c++17 -Wall -Wextra -Werror -I../include mapped_ring_buffer.cpp
+/*
+This is free and unencumbered software released into the public domain.
+
+Anyone is free to copy, modify, publish, use, compile, sell, or
+distribute this software, either in source code form or as a compiled
+binary, for any purpose, commercial or non-commercial, and by any
+means.
+
+In jurisdictions that recognize copyright laws, the author or authors
+of this software dedicate any and all copyright interest in the
+software to the public domain. We make this dedication for the benefit
+of the public at large and to the detriment of our heirs and
+successors. We intend this dedication to be an overt act of
+relinquishment in perpetuity of all present and future rights to this
+software under copyright law.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+
+For more information, please refer to <http://unlicense.org>
+*/
+/// \author Selcuk Iyikalender
+/// \date   2026
+
+#include <cassert>
+
+#include <haluj/mapped_ring_buffer.hpp>
+
+int main()
+{
+  haluj::mapped_ring_buffer<int> rb;
+  assert(rb.open(1));
+
+  // fill, wrapping the tail once
+  assert(rb.push(-1));
+  rb.pop();
+  for (std::size_t i = 0; i < rb.capacity(); i++)
+  {
+    assert(rb.push(static_cast<int>(i)));
+  }
+  assert(rb.full());
+
+  // a push into a full buffer is rejected and changes nothing
+  assert(!rb.push(-2));
+  assert(rb.size() == rb.capacity());
+  assert(rb.front() == 0);
+  assert(rb.back() == static_cast<int>(rb.capacity() - 1));
+
+  rb.pop();
+  assert(rb.push(-3));
+  assert(rb.front() == 1 && rb.back() == -3);
+
+  return 0;
+}
@@ -0,0 +1,81 @@
+/// \file parse_lines.cpp
+/// parse_lines test:
+/// g++ -std=c++17 -pthread -I../include parse_lines.cpp
+/*
+This is free and unencumbered software released into the public domain.
+
+Anyone is free to copy, modify, publish, use, compile, sell, or
+distribute this software, either in source code form or as a compiled
+binary, for any purpose, commercial or non-commercial, and by any
+means.
+
+In jurisdictions that recognize copyright laws, the author or authors
+of this software dedicate any and all copyright interest in the
+software to the public domain. We make this dedication for the benefit
+of the public at large and to the detriment of our heirs and
+successors. We intend this dedication to be an overt act of
+relinquishment in perpetuity of all present and future rights to this
+software under copyright law.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+
+For more information, please refer to <http://unlicense.org>
+*/
+/// \author Selcuk Iyikalender
+/// \date   2026
+
+#include <cassert>
+#include <stdexcept>
+#include <string>
+
+#include <haluj/parse_lines.hpp>
+
+int main()
+{
+  // enough lines for four chunks
+  std::string input;
+  for (int i = 0; i < 100000; i++)
+  {
+    input += std::to_string(i) + '\n';
+  }
+  const haluj::fragment<const char*> lines(input.data(), input.data() + input.size());
+
+  auto count = [](const haluj::fragment<const char*>& p_line, std::size_t& p_result)
+  {
+    p_result = p_line.size();
+    return true;
+  };
+  assert(haluj::parse_lines<std::size_t>(lines, count, 4).size() == 100000);
+
+  // a throwing line function in any chunk reaches the caller
+  for (const std::string bad : { "10", "99999" })
+  {
+    bool caught = false;
+    try
+    {
+      haluj::parse_lines<std::size_t>(lines,
+        [&](const haluj::fragment<const char*>& p_line, std::size_t& p_result)
+        {
+          if (std::string(p_line.begin(), p_line.end()) == bad)
+          {
+            throw std::runtime_error(bad);
+          }
+          p_result = p_line.size();
+          return true;
+        }, 4);
+    }
+    catch (const std::runtime_error& e)
+    {
+      caught = (e.what() == bad);
+    }
+    assert(caught);
+  }
+
+  return 0;
+}
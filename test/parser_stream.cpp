@@ -0,0 +1,117 @@
+/// \file parser_stream.cpp
+/// parser_stream test:
+/// g++ -std=c++17 -I../include parser_stream.cpp
+/*
+This is free and unencumbered software released into the public domain.
+
+Anyone is free to copy, modify, publish, use, compile, sell, or
+distribute this software, either in source code form or as a compiled
+binary, for any purpose, commercial or non-commercial, and by any
+means.
+
+In jurisdictions that recognize copyright laws, the author or authors
+of this software dedicate any and all copyright interest in the
+software to the public domain. We make this dedication for the benefit
+of the public at large and to the detriment of our heirs and
+successors. We intend this dedication to be an overt act of
+relinquishment in perpetuity of all present and future rights to this
+software under copyright law.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+
+For more information, please refer to <http://unlicense.org>
+*/
+/// \author Selcuk Iyikalender
+/// \date   2026
+
+#include <cassert>
+#include <string>
+#include <utility>
+
+#include <haluj/parser_stream.hpp>
+
+using namespace haluj;
+
+/// buffer exposing its content as two spans, split in the middle
+struct buffer
+{
+  typedef fragment<const char*> span_type;
+
+  std::pair<span_type, span_type> read_spans() const
+  {
+    const char* d = data.data();
+    const char* m = d + data.size() / 2;
+    return std::make_pair(span_type(d, m), span_type(m, d + data.size()));
+  }
+
+  void commit_read(std::size_t p_count)
+  {
+    data.erase(0, p_count);
+  }
+
+  std::string data;
+};
+
+/// counts how often the frame is parsed
+template<typename RuleType>
+struct counted
+{
+  template<typename Iterator>
+  bool accept(Iterator& p_first, Iterator p_last) const
+  {
+    (*count)++;
+    return rule.accept(p_first, p_last);
+  }
+
+  RuleType  rule;
+  int*      count;
+};
+
+int main()
+{
+  int parses  = 0;
+  auto line   = seq(om(alpha()), ch('\n'));
+  auto rule   = counted<decltype(line)>{line, &parses};
+
+  // a large frame received one element at a time
+  const std::string frame = std::string(10000, 'a') + '\n';
+  buffer            b;
+
+  auto parser = frame_parser(rule, '\n');
+  for (std::size_t i = 0; i + 1 < frame.size(); i++)
+  {
+    b.data += frame[i];
+    assert(parser(b) == parse_result::partial);
+  }
+  assert(parses == 0);
+
+  b.data += "\n\nb\nc";
+  assert(parser(b) == parse_result::success && b.data == "\nb\nc");
+  assert(parses == 1);
+
+  // an empty line is malformed, the next frames follow it
+  assert(parser(b) == parse_result::failure);
+  b.commit_read(1);
+  assert(parser(b) == parse_result::success && b.data == "c");
+  assert(parser(b) == parse_result::partial);
+  assert(parses == 3);
+  assert(parser(b, true) == parse_result::failure);
+
+  // parse_stream gives the same frames, parsing them again per chunk
+  parses = 0;
+  b.data.clear();
+  for (char c : frame)
+  {
+    b.data += c;
+    parse_stream(rule, b);
+  }
+  assert(b.data.empty() && parses == static_cast<int>(frame.size()));
+
+  return 0;
+}
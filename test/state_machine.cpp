@@ -0,0 +1,62 @@
+/// \file state_machine.cpp
+/// Flat state machine test, must build warning clean:
+/// g++ -std=c++17 -Wall -Wextra -Werror -I../include state_machine.cpp
+/*
+This is free and unencumbered software released into the public domain.
+
+Anyone is free to copy, modify, publish, use, compile, sell, or
+distribute this software, either in source code form or as a compiled
+binary, for any purpose, commercial or non-commercial, and by any
+means.
+
+In jurisdictions that recognize copyright laws, the author or authors
+of this software dedicate any and all copyright interest in the
+software to the public domain. We make this dedication for the benefit
+of the public at large and to the detriment of our heirs and
+successors. We intend this dedication to be an overt act of
+relinquishment in perpetuity of all present and future rights to this
+software under copyright law.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+
+For more information, please refer to <http://unlicense.org>
+*/
+/// \author Selcuk Iyikalender
+/// \date   2026
+
+#include <cassert>
+#include <tuple>
+
+#include <haluj/state_machine.hpp>
+
+enum class state { off, on };
+
+int main()
+{
+  int entered = 0;
+
+  auto key    = [](char c) { return [c](char e) { return e == c; }; };
+  auto enter  = [&](char) { entered++; };
+  auto none   = [](char) {};
+
+  auto m = haluj::machine(
+    haluj::graph(haluj::transition<state::off, state::on>(key('1')),
+                 haluj::transition<state::on, state::off>(key('0'))),
+    haluj::map(haluj::entry<state::off>(std::make_tuple(none, none, none)),
+               haluj::entry<state::on>(std::make_tuple(enter, none, none))));
+
+  state s = state::off;
+  s = m(s, '0');  assert(s == state::off);
+  s = m(s, '1');  assert(s == state::on);
+  s = m(s, '1');  assert(s == state::on);
+  s = m(s, '0');  assert(s == state::off);
+  assert(entered == 1);
+
+  return 0;
+}